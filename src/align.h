@@ -32,6 +32,63 @@ static inline size_t xAlignSize(size_t size) {
           (~__XMALLOC_SIZEOF_ALIGNMENT_MINUS_ONE));
 }
 
+/**
+ * \brief Largest alignment of blocks taken from bins. Pages of a bin whose
+ * block size is a multiple of 32 or a higher power of 2 start their first
+ * block at the next multiple of it after the page header, see
+ * xAlignedPageHeaderSize().
+ */
+#define __XMALLOC_MAX_BIN_ALIGNMENT   (__XMALLOC_SIZEOF_SYSTEM_PAGE / 2)
+
+/**
+ * \fn static inline size_t xBlockAlignmentOfSize(size_t size)
+ *
+ * \brief Alignment of all blocks of a bin of block size \c size , i.e. the
+ * largest power of 2 dividing \c size , at most
+ * __XMALLOC_MAX_BIN_ALIGNMENT.
+ *
+ * \param size block size in bytes
+ *
+ * \return alignment of the blocks
+ *
+ */
+static inline size_t xBlockAlignmentOfSize(size_t size) {
+  size_t alignment  = size & (~size + 1);
+  return (alignment > __XMALLOC_MAX_BIN_ALIGNMENT ?
+          __XMALLOC_MAX_BIN_ALIGNMENT : alignment);
+}
+
+/**
+ * \fn static inline size_t xAlignedPageHeaderSize(size_t size)
+ *
+ * \brief Offset of the first block in a page of blocks of size \c size :
+ * The page header rounded up to the alignment of the blocks. For the static
+ * bins of a block size divisible by 32 no page loses a block by this.
+ *
+ * \param size block size in bytes
+ *
+ * \return offset of the first block
+ *
+ */
+static inline size_t xAlignedPageHeaderSize(size_t size) {
+  size_t alignment  = xBlockAlignmentOfSize(size);
+  return ((__XMALLOC_SIZEOF_PAGE_HEADER + alignment - 1) & ~(alignment - 1));
+}
+
+/**
+ * \fn static inline int xIsAlignment(size_t alignment)
+ *
+ * \brief Checks if \c alignment is a power of 2.
+ *
+ * \param alignment alignment to be checked
+ *
+ * \return true if \c alignment is a power of 2, false else
+ *
+ */
+static inline int xIsAlignment(size_t alignment) {
+  return (0 != alignment && 0 == (alignment & (alignment - 1)));
+}
+
 #ifndef _XMALLOC_NDEBUG
 /**
  * \fn static inline int xAddressIsAligned(void *addr)
@@ -0,0 +1,93 @@
+/**
+ * \file   arena.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  General source file for non-inline arena handling functions.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include "src/xmalloc.h"
+
+/* bin owning the pages of arenas: it has no blocks, so frees to its pages
+ * always take the slow path */
+struct xBinStruct __XMALLOC_ARENA_BIN[] =
+  {{__XMALLOC_ZERO_PAGE, NULL, NULL, 0, 0, 0, NULL}};
+
+/************************************************
+ * ARENA ALLOCATION
+ ***********************************************/
+xArena xArenaCreate()
+{
+  xArena arena;
+  __XMALLOC_RECORD_SUSPEND();
+  arena = xMalloc(sizeof(xArenaType));
+  __XMALLOC_RECORD_RESUME();
+  arena->lastPage = NULL;
+  arena->current  = NULL;
+  arena->end      = NULL;
+  return arena;
+}
+
+/* the number of pages of an arena page is stored negated in
+ * numberUsedBlocks, as for pages of bins of big blocks this keeps it <= 0 */
+static xPage xArenaAllocPages(xArena arena, int numberPages)
+{
+  xPage page  = (1 == numberPages ? xAllocSmallBlockPageForBin() :
+                  xAllocBigBlockPagesForBin(numberPages));
+  xSetBinOfPage(page, __XMALLOC_ARENA_BIN);
+  page->numberUsedBlocks  = - numberPages;
+  page->current           = NULL;
+  page->next              = NULL;
+  page->prev              = arena->lastPage;
+  arena->lastPage         = page;
+  return page;
+}
+
+void* xArenaAllocFault(xArena arena, size_t size)
+{
+  xPage page;
+  char *addr;
+  int numberPages = (int) ((size + __XMALLOC_SIZEOF_PAGE_HEADER +
+                      __XMALLOC_SIZEOF_SYSTEM_PAGE - 1) /
+                      __XMALLOC_SIZEOF_SYSTEM_PAGE);
+
+  page  = xArenaAllocPages(arena, numberPages);
+  addr  = (char *) page + __XMALLOC_SIZEOF_PAGE_HEADER;
+  // further objects are bumped into the new page if it has more space left
+  // than the current one, always the case if size is small
+  if (1 == numberPages && (char *) page + __XMALLOC_SIZEOF_SYSTEM_PAGE -
+      (addr + size) > arena->end - arena->current)
+  {
+    arena->current  = addr + size;
+    arena->end      = (char *) page + __XMALLOC_SIZEOF_SYSTEM_PAGE;
+  }
+  return addr;
+}
+
+/************************************************
+ * ARENA FREEING
+ ***********************************************/
+void xArenaRelease(xArena arena, xArenaMarkType mark)
+{
+  xPage page;
+  while (arena->lastPage != mark.lastPage)
+  {
+    page  = arena->lastPage;
+    __XMALLOC_ASSERT(NULL != page);
+    __XMALLOC_ASSERT(__XMALLOC_ARENA_BIN == xGetBinOfPage(page));
+    arena->lastPage = page->prev;
+    xFreePagesFromRegion(page, - page->numberUsedBlocks);
+  }
+  arena->current  = mark.current;
+  arena->end      = mark.end;
+}
+
+void xArenaDestroy(xArena arena)
+{
+  xArenaMarkType empty  = { NULL, NULL, NULL };
+  xArenaRelease(arena, empty);
+  __XMALLOC_RECORD_SUSPEND();
+  xFree(arena);
+  __XMALLOC_RECORD_RESUME();
+}
@@ -0,0 +1,125 @@
+/**
+ * \file   arena.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Arenas for xmalloc: Temporary objects of a computation are bumped
+ *         into pages of the regions one after the other, without headers
+ *         and free lists. They are not freed one by one, but all at once by
+ *         releasing the arena to a mark taken before or by destroying it,
+ *         which costs one step per page.
+ *         Pages of arenas are registered as the ones of bins, so
+ *         xIsBinAddr() is true for objects of an arena. They belong to
+ *         __XMALLOC_ARENA_BIN and every free to them ends up in
+ *         xFreeToPageFault(), which reports the error instead of corrupting
+ *         the arena.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_ARENA_H
+#define XMALLOC_ARENA_H
+
+#include <stdlib.h>
+#include "xassert.h"
+#include "xmalloc-config.h"
+#include "data.h"
+#include "globals.h"
+#include "align.h"
+
+/**
+ * \fn xArena xArenaCreate()
+ *
+ * \brief Creates a new empty arena.
+ *
+ * \return \c xArena created
+ *
+ */
+xArena xArenaCreate();
+
+/**
+ * \fn void* xArenaAllocFault(xArena arena, size_t size)
+ *
+ * \brief Allocates \c size bytes in \c arena if they do not fit into the
+ * current page of \c arena : The object is put at the start of a new page,
+ * resp. of consecutive pages if it is too large for one. Further objects are
+ * bumped into the new page if it has more space left than the current one.
+ *
+ * \param arena \c xArena
+ *
+ * \param size \c size_t aligned by \c xAlignSize()
+ *
+ * \return address of the memory allocated
+ *
+ */
+void* xArenaAllocFault(xArena arena, size_t size);
+
+/**
+ * \fn static inline void* xArenaAlloc(xArena arena, size_t size)
+ *
+ * \brief Allocates \c size bytes in \c arena . The memory is aligned to
+ * __XMALLOC_SIZEOF_ALIGNMENT, it cannot be freed on its own, but only by
+ * \c xArenaRelease() or \c xArenaDestroy() .
+ *
+ * \param arena \c xArena
+ *
+ * \param size \c size_t number of bytes
+ *
+ * \return address of the memory allocated
+ *
+ */
+static inline void* xArenaAlloc(xArena arena, size_t size)
+{
+  char *addr  = arena->current;
+  size        = xAlignSize(0 == size ? 1 : size);
+  if (size <= (size_t) (arena->end - addr))
+  {
+    arena->current  = addr + size;
+    return addr;
+  }
+  return xArenaAllocFault(arena, size);
+}
+
+/**
+ * \fn static inline xArenaMarkType xArenaMark(const xArena arena)
+ *
+ * \brief Marks the state of \c arena .
+ *
+ * \param arena \c xArena
+ *
+ * \return mark to be passed to \c xArenaRelease()
+ *
+ */
+static inline xArenaMarkType xArenaMark(const xArena arena)
+{
+  xArenaMarkType mark;
+  mark.lastPage = arena->lastPage;
+  mark.current  = arena->current;
+  mark.end      = arena->end;
+  return mark;
+}
+
+/**
+ * \fn void xArenaRelease(xArena arena, xArenaMarkType mark)
+ *
+ * \brief Frees all memory allocated in \c arena after \c mark was taken. The
+ * pages allocated since then are given back to their regions.
+ *
+ * \param arena \c xArena
+ *
+ * \param mark \c xArenaMarkType taken by \c xArenaMark(arena) , it must not
+ * have been released before by an earlier mark
+ *
+ */
+void xArenaRelease(xArena arena, xArenaMarkType mark);
+
+/**
+ * \fn void xArenaDestroy(xArena arena)
+ *
+ * \brief Frees all memory allocated in \c arena and \c arena itself.
+ *
+ * \param arena \c xArena
+ *
+ */
+void xArenaDestroy(xArena arena);
+
+#endif
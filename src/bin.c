@@ -12,6 +12,12 @@
 // extern declaration in globals.h
 xPage xPageForMalloc  = (xPage)1;
 xRegion xBaseRegion    = NULL;
+unsigned long xNumberEmptyRegions = 0;
+
+/* set by xAllocSmallBlockPageForBin() and xAllocBigBlockPagesForBin() if the
+ * pages are taken from the initial chunk of a region, i.e. they were never
+ * used before */
+static int xFreshPages = 0;
 
 
 //void xUnGetSpecBin(xBin* bin) {
@@ -61,28 +67,48 @@ xRegion xBaseRegion    = NULL;
 /************************************************
  * ALLOCATING PAGES FOR BINS
  ***********************************************/
+/* blocks of a size divisible by a higher power of 2 than the page header
+ * start at the next multiple of it, if they still fit into the page, so that
+ * all blocks of the page keep the alignment of their size */
+static inline size_t xFirstBlockOffset(xBin bin)
+{
+  size_t size   = bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+  size_t offset = xAlignedPageHeaderSize(size);
+  if (bin->numberBlocks < 0 || offset + bin->numberBlocks * size >
+      __XMALLOC_SIZEOF_SYSTEM_PAGE)
+    return __XMALLOC_SIZEOF_PAGE_HEADER;
+  return offset;
+}
+
 xPage xAllocNewPageForBin(xBin bin)
 {
   xPage newPage;
   char *tmp;
   int i = 1;
+  int numberPages = xPagesOfBin(bin);
+  __XMALLOC_LATENCY_START(start);
 
   // block size < page size
 #if __XMALLOC_DEBUG > 1
   printf("binNumberBlocks %ld in %p\n",bin->numberBlocks,bin);
 #endif
-  if (bin->numberBlocks > 0)
+  if (1 == numberPages)
   {
     newPage = xAllocSmallBlockPageForBin();
   }
-  // block size > page size
+  // block size > page size or span of blocks
   else
-    newPage = xAllocBigBlockPagesForBin(-bin->numberBlocks);
+  {
+    newPage = xAllocBigBlockPagesForBin(numberPages);
+    // blocks start on all system pages of a span, the ones behind the first
+    // page are found by xGetPageOfSpanAddr()
+    if (bin->numberBlocks > 0)
+      xRegisterSpanTail(newPage, numberPages);
+  }
 
   xSetTopBinAndStickyOfPage(newPage, bin);
   newPage->numberUsedBlocks = -1;
-  newPage->current  = (void*) (((char*) newPage) +
-                        __XMALLOC_SIZEOF_PAGE_HEADER);
+  newPage->current  = (void*) (((char*) newPage) + xFirstBlockOffset(bin));
   tmp               = newPage->current;
   while (i < bin->numberBlocks)
   {
@@ -90,10 +116,20 @@ xPage xAllocNewPageForBin(xBin bin)
     i++;
   }
   __XMALLOC_NEXT(tmp) = NULL;
+#ifdef __XMALLOC_HAVE_MMAP
+  // pages fresh from mmap are zero, only the links above were written
+  bin->zero = (xFreshPages ? newPage->current : NULL);
+#else
+  bin->zero = NULL;
+#endif
+  __XMALLOC_PROBE4(page__alloc, bin,
+      bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT, bin->numberBlocks,
+      newPage);
 
 #if __XMALLOC_DEBUG > 1
   printf("PAGEUSEDBLOCKS %ld\n", newPage->numberUsedBlocks);
 #endif
+  __XMALLOC_LATENCY_STOP(xLatency_NewPageForBin, start);
   return newPage;
 }
 
@@ -111,6 +147,7 @@ xPage xAllocSmallBlockPageForBin()
     {
       newPage             = xBaseRegion->current;
       xBaseRegion->current = __XMALLOC_NEXT(newPage);
+      xFreshPages         = 0;
       goto Found;
     }
     // there exist pages in this region we can use
@@ -122,6 +159,7 @@ xPage xAllocSmallBlockPageForBin()
         xBaseRegion->initAddr  +=  __XMALLOC_SIZEOF_SYSTEM_PAGE;
       else
         xBaseRegion->initAddr  =   NULL;
+      xFreshPages = 1;
       goto Found;
     }
     // there exists already a next region we can allocate from
@@ -139,6 +177,8 @@ xPage xAllocSmallBlockPageForBin()
 
   Found:
   newPage->region = xBaseRegion;
+  if (0 == xBaseRegion->numberUsedPages)
+    xNumberEmptyRegions--;
   xBaseRegion->numberUsedPages++;
 
 #ifndef __XMALLOC_NDEBUG
@@ -174,12 +214,18 @@ xPage xAllocBigBlockPagesForBin(int numberNeeded)
       }
       else
         region->initAddr  =   NULL;
+      xFreshPages = 1;
       //goto Found;
     }
     // check if there is a consecutive chunk of numberNeeded pages in region we
     // can get
     if (page==NULL)
+    {
+      __XMALLOC_LATENCY_START(start);
       page  = xGetConsecutivePagesFromRegion(region, numberNeeded);
+      __XMALLOC_LATENCY_STOP(xLatency_ConsecutivePages, start);
+      xFreshPages = 0;
+    }
     if (NULL != page)
       goto Found;
     // there already exists a next region we can allocate from
@@ -198,6 +244,8 @@ xPage xAllocBigBlockPagesForBin(int numberNeeded)
 
   Found:
   page->region            =   region;
+  if (0 == region->numberUsedPages)
+    xNumberEmptyRegions--;
   region->numberUsedPages +=  numberNeeded;
 
   if (xBaseRegion != region)
@@ -215,26 +263,79 @@ xPage xAllocBigBlockPagesForBin(int numberNeeded)
   return page;
 }
 
+/**********************************************
+ * ALLOCATING NEAR OTHER BLOCKS
+ *********************************************/
+void xAllocFromPageFault(xPage page, xBin bin)
+{
+  __XMALLOC_ASSERT(NULL == page->current);
+  __XMALLOC_ASSERT(page != bin->currentPage);
+  xTakeOutPageFromBin(page, bin);
+  page->next              = bin->currentPage;
+  page->prev              = bin->currentPage->prev;
+  if (NULL != page->prev)
+    page->prev->next      = page;
+  bin->currentPage->prev  = page;
+  // as in xAllocFromFullPage() the first free moves the page behind the
+  // current one again
+  page->numberUsedBlocks  = 0;
+}
+
+void* xAllocFromBinNearRegion(xBin bin, xRegion region)
+{
+  xPage page  = bin->currentPage;
+  int i;
+  if (__XMALLOC_ZERO_PAGE == page || region == page->region)
+    return xAllocFromBin(bin);
+  // the pages behind the current one are the ones with free blocks
+  for (i = 0, page = page->next;
+       i < __XMALLOC_NEAR_SEARCH_PAGES && NULL != page;
+       i++, page = page->next)
+  {
+    if (region == page->region && NULL != page->current)
+      return xAllocFromPageOfBin(page, bin);
+  }
+  return xAllocFromBin(bin);
+}
+
 /**********************************************
  * PAGE FREEING
  *********************************************/
+void xFreePagesOfBin(xPage page, xBin bin)
+{
+  int numberPages = xPagesOfBin(bin);
+  if (bin->numberBlocks > 0 && numberPages > 1)
+    xUnregisterSpanTail(page, numberPages);
+  xFreePagesFromRegion(page, numberPages);
+}
+
 void xFreeToPageFault(xPage page, void *addr)
 {
   __XMALLOC_ASSERT(page->numberUsedBlocks <= 0L);
   xBin bin  = xGetBinOfPage(page);
+  if (__XMALLOC_ARENA_BIN == bin)
+  {
+    xReportError("%p is in an arena, it is freed by xArenaRelease() or "
+        "xArenaDestroy() only\n", addr);
+    return;
+  }
   if ((NULL != page->current) || (bin->numberBlocks <= 1))
   {
     // collect all blocks of page
     xTakeOutPageFromBin(page, bin);
     // page can be freed
-    if (bin->numberBlocks > 0)
-      xFreePagesFromRegion(page,1);
-    else
-      xFreePagesFromRegion(page, - bin->numberBlocks);
+    __XMALLOC_TRACE_EVENT(xTrace_PageRelease, page, xPagesOfBin(bin));
+    __XMALLOC_PROBE4(page__fault, bin,
+        bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT, page,
+        xPagesOfBin(bin));
+    xFreePagesOfBin(page, bin);
   }
   else
   {
     // page was full
+    __XMALLOC_TRACE_EVENT(xTrace_PageRelease, page, 0);
+    __XMALLOC_PROBE4(page__fault, bin,
+        bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT, page, 0);
     page->current           = addr;
     page->numberUsedBlocks  = bin->numberBlocks - 2;
     *((void **) addr)       = NULL;
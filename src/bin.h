@@ -23,6 +23,10 @@
 #include "page.h"
 #include "region.h"
 #include "align.h"
+#include "copy.h"
+#include "trace.h"
+#include "probes.h"
+#include "histogram.h"
 
 /************************************************
  * NOTE: The functionality of getting and freeing
@@ -49,6 +53,7 @@
  *    => define \c __XMALLOC_PAGE_AFTER_CURRENT
  * 3. Insert before \c current_page , i.e. let it be the new current page
  *    => define \c __XMALLOC_PAGE_BEFORE_CURRENT
+ * Freeing memory of an arena is reported as error and ignored.
  *
  * \param page \c xPage the freed memory should be given to
  *
@@ -60,7 +65,10 @@ void xFreeToPageFault(xPage page, void *addr); // TOODOO
 /**
  * \fn static inline void xFreeToPage(xPage page, void *addr)
  *
- * \brief Frees memory at \c addr to \c xPage \c page .
+ * \brief Frees memory at \c addr to \c xPage \c page . Every free counts
+ * down \c page->numberUsedBlocks , so the free of the last used block of
+ * the page reaches \c xFreeToPageFault() , which gives the page back to its
+ * region.
  *
  * \param page \c xPage the freed memory should be given to
  *
@@ -73,6 +81,7 @@ static inline void xFreeToPage(xPage page, void *addr)
   {
     *((void **) addr) = page->current;
     page->current     = addr;
+    page->numberUsedBlocks--;
   }
   else
   {
@@ -105,149 +114,58 @@ static inline int xIsStickyBin(xBin bin) {
 
 
 /************************************************
- * LIST HANDLING FOR SPECIAL BINS
+ * HASH TABLE OF SPECIAL BINS
  ***********************************************/
-
 /**
- * \fn static inline void* xFindInSortedList(xSpecBin bin, long numberBlocks)
- *
- * \brief Tries to find a special bin for the size class given by
- * \c numberBlocks . If there does not exist such a special bin, then
- * it returns NULL. Here the list searched through is already sorted by
- * increasing size classes.
+ * \fn static inline unsigned long xSpecBinSlot(long numberBlocks)
  *
- * \param bin \c xSpecBin usually base of special bins, but can be any
- * \c xSpecBin .
+ * \brief First slot in xSpecBinTable to look for the spec bin of
+ * \c numberBlocks blocks per page. The table is probed linearly from there.
  *
  * \param numberBlocks \c long number of blocks in bin, i.e. size class
- * needed for special bin.
+ * of the spec bin.
  *
- * \return address of found xSpecBin, NULL if none is found
- */
-static inline void* xFindInSortedList(xSpecBin bin, long numberBlocks) {
-  while (NULL != bin) {
-    if (bin->numberBlocks >= numberBlocks) {
-      if (bin->numberBlocks == numberBlocks)
-        return bin;
-      // list is sorted, thus we know that there does not exist
-      // such a special bin we need in this list
-      return NULL;
-    }
-    bin = bin->next;
-  }
-  return NULL;
-}
-
-/**
- * \fn static inline void* xFindInList(xSpecBin bin, long numberBlocks, xSpecBin
- * sBin)
- *
- * \brief Tries to find a special bin for the size class given by
- * \c numberBlocks . If there does not exist such a special bin, then
- * it returns NULL. Here the list searched through is possibly not sorted.
- *
- * \param bin \c xSpecBin usually base of special bins, but can be any
- * \c xSpecBin .
+ * \return index in xSpecBinTable
  *
- * \param numberBlocks \c long number of blocks in bin, i.e. size class
- * needed for special bin.
+ * \note xSpecBinTableSize is a power of 2.
  *
- * \param sBin \c xSpecBin to be found in the list.
- *
- * \return address of found xSpecBin, NULL if none is found
  */
-static inline void* xFindInList(xSpecBin bin, long numberBlocks, xSpecBin sBin) {
-  while (NULL != bin) {
-    if (bin->numberBlocks == numberBlocks)
-      return bin;
-    bin = bin->next;
-  }
-  return NULL;
+static inline unsigned long xSpecBinSlot(long numberBlocks)
+{
+  return ((unsigned long) numberBlocks * 2654435761UL) &
+          (xSpecBinTableSize - 1);
 }
 
 /**
- * \fn static inline void* xInsertIntoSortedList(xSpecBin rootBin, xSpecBin sBin,
- * long numberBlocks)
- *
- * \brief Inserts spec bin \c bin into sorted list of spec bins. The list is
- * sorted by increasing \c numberBlocks .
- *
- * \param rootBin \c xSpecBin usually root of the list of special bins, but can be
- * any \c xSpecBin .
+ * \fn static inline xSpecBin xFindSpecBin(long numberBlocks,
+ *      size_t sizeInWords)
  *
- * \param sBin \c xSpecBin special bin to be inserted into the list of special
- * bins
+ * \brief Tries to find the spec bin for the size class given by
+ * \c numberBlocks and \c sizeInWords . Bins of spans of different lengths may
+ * have the same number of blocks per page, so both are compared. The expected
+ * number of probes is constant, independent of the number of spec bins.
  *
  * \param numberBlocks \c long number of blocks in bin, i.e. size class
  * needed for special bin.
  *
- * \return address of the root of the list of the special bins.
- *
- */
-static inline xSpecBin xInsertIntoSortedList(xSpecBin rootBin, xSpecBin sBin,
-    long numberBlocks) {
-  if (NULL == rootBin || numberBlocks <= rootBin->numberBlocks) {
-    sBin->next = rootBin;
-    return sBin;
-  } else {
-    xSpecBin prev = rootBin;
-    xSpecBin curr = rootBin->next;
-
-    while (NULL != curr && curr->numberBlocks < numberBlocks) {
-      prev  = curr;
-      curr  = curr->next;
-    }
-    prev->next  = sBin;
-    sBin->next  = curr;
-
-    return rootBin;
-  }
-}
-
-/**
- * \fn static inline xSpecBin xRemoveFromSortedList(xSpecBin rootBin, xSpecBin sBin)
- *
- * \brief Removes \c sBin from list of spec bins beginning at \c rootBin .
+ * \param sizeInWords \c size_t size of the blocks in words
  *
- * \param rootBin \c xSpecBin usually root of the list of special bins, but can be
- * any \c xSpecBin .
- *
- * \param sBin \c xSpecBin special bin to be removed from the list of special
- * bins
- *
- * \return address of the root of the list of the special bins.
+ * \return address of found xSpecBin, NULL if none is found
  *
  */
-static inline xSpecBin xRemoveFromSortedList(xSpecBin rootBin, xSpecBin sBin)
+static inline xSpecBin xFindSpecBin(long numberBlocks, size_t sizeInWords)
 {
-  // if root of spec bins is NULL, we are done
-  if (NULL == rootBin)
+  unsigned long i;
+  if (0 == xNumberSpecBins)
     return NULL;
-
-  xSpecBin listIterator       = rootBin->next;
-  long numberBlocks  = sBin->numberBlocks;
-
-  // if root of spec bins coincides with sBin, just cut it out
-  if (rootBin == sBin)
-    return listIterator;
-  // now we really need to search for sBin in the list of spec bins
-  // NOTE: If root of spec bins has a greater number of blocks, then we are
-  // done at the first step since sBin cannot be in this list at all
-
-  // we need to remember the starting point of the list of spec bins
-  xSpecBin rootBinAnchor = rootBin;
-  while (NULL != listIterator && listIterator != sBin)
+  for (i = xSpecBinSlot(numberBlocks); NULL != xSpecBinTable[i];
+       i = (i + 1) & (xSpecBinTableSize - 1))
   {
-    if (rootBin->numberBlocks > numberBlocks)
-      return rootBinAnchor;
-    rootBin       = listIterator;
-    listIterator  = listIterator->next;
+    if (xSpecBinTable[i]->bin.numberBlocks == numberBlocks &&
+        xSpecBinTable[i]->bin.sizeInWords == sizeInWords)
+      return xSpecBinTable[i];
   }
-
-  if (NULL != listIterator)
-    rootBin->next = listIterator->next;
-
-  return rootBinAnchor;
+  return NULL;
 }
 
 /************************************************
@@ -363,6 +281,87 @@ xPage xAllocSmallBlockPageForBin();
  */
 xPage xAllocBigBlockPagesForBin(int numberNeeded);
 
+/************************************************
+ * SPANS OF BINS
+ ***********************************************/
+/**
+ * \brief Maximal number of system pages of a span, i.e. of a page of a bin
+ * of blocks larger than __XMALLOC_MAX_SMALL_BLOCK_SIZE .
+ */
+#define __XMALLOC_MAX_SPAN_PAGES      16
+
+/**
+ * \brief Page header and tail of a span not used by its blocks are at most
+ * 1/__XMALLOC_SPAN_WASTE_DIVISOR of it, if __XMALLOC_MAX_SPAN_PAGES system
+ * pages are enough for this.
+ */
+#define __XMALLOC_SPAN_WASTE_DIVISOR  50
+
+/**
+ * \fn static inline int xSpanPagesOfSize(size_t size)
+ *
+ * \brief Number of system pages a page of the bin of blocks of \c size bytes
+ * spans. A page of one system page holds only 1 to 3 of the blocks larger
+ * than the ones of the static bins, wasting up to half of it, so these bins
+ * get the fewest pages keeping the waste below 1/__XMALLOC_SPAN_WASTE_DIVISOR .
+ *
+ * \param size \c size_t aligned size of the blocks, at most
+ * __XMALLOC_SIZEOF_PAGE
+ *
+ * \return number of system pages, between 1 and __XMALLOC_MAX_SPAN_PAGES
+ *
+ */
+static inline int xSpanPagesOfSize(size_t size)
+{
+  int numberPages = 1;
+  size_t spanSize = __XMALLOC_SIZEOF_SYSTEM_PAGE;
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+    return 1;
+  while (numberPages < __XMALLOC_MAX_SPAN_PAGES &&
+         (__XMALLOC_SIZEOF_PAGE_HEADER + (spanSize -
+          __XMALLOC_SIZEOF_PAGE_HEADER) % size) *
+         __XMALLOC_SPAN_WASTE_DIVISOR > spanSize)
+  {
+    numberPages++;
+    spanSize  +=  __XMALLOC_SIZEOF_SYSTEM_PAGE;
+  }
+  return numberPages;
+}
+
+/**
+ * \fn static inline int xPagesOfBin(const xBin bin)
+ *
+ * \brief Number of system pages of a page of \c bin . Only the first one is
+ * registered in xPageShifts, for a span of blocks the others are marked by
+ * \c xRegisterSpanTail() .
+ *
+ * \param bin Const \c xBin
+ *
+ * \return number of system pages
+ *
+ */
+static inline int xPagesOfBin(const xBin bin)
+{
+  if (bin->numberBlocks < 0)
+    return (int) - bin->numberBlocks;
+  return (int) ((__XMALLOC_SIZEOF_PAGE_HEADER + bin->numberBlocks *
+          (bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT) +
+          __XMALLOC_SIZEOF_SYSTEM_PAGE - 1) / __XMALLOC_SIZEOF_SYSTEM_PAGE);
+}
+
+/**
+ * \fn void xFreePagesOfBin(xPage page, xBin bin)
+ *
+ * \brief Gives \c page of \c bin back to its region, all of its system
+ * pages. The page must be taken out of \c bin before.
+ *
+ * \param page \c xPage without used blocks
+ *
+ * \param bin \c xBin \c page belonged to
+ *
+ */
+void xFreePagesOfBin(xPage page, xBin bin);
+
 /************************************************
  * ALLOCATING PAGES IN BINS
  ***********************************************/
@@ -379,6 +378,7 @@ xPage xAllocBigBlockPagesForBin(int numberNeeded);
 static inline void* xAllocFromFullPage(xBin bin)
 {
   xPage newPage;
+  void *addr;
   if (__XMALLOC_ZERO_PAGE != bin->currentPage)
   {
     bin->currentPage->numberUsedBlocks  = 0;
@@ -396,8 +396,12 @@ static inline void* xAllocFromFullPage(xBin bin)
   __XMALLOC_ASSERT(NULL != newPage);
   __XMALLOC_ASSERT(__XMALLOC_ZERO_PAGE != newPage);
   __XMALLOC_ASSERT(NULL != newPage->current);
+  __XMALLOC_TRACE_EVENT(xTrace_PageRefill, bin, newPage);
   bin->currentPage  = newPage;
-  return xAllocFromNonEmptyPage(newPage);
+  addr  = xAllocFromNonEmptyPage(newPage);
+  if (addr == bin->zero)
+    bin->zero = newPage->current;
+  return addr;
 }
 
 /************************************************
@@ -421,13 +425,47 @@ static inline void* xAllocFromFullPage(xBin bin)
  */
 static inline void* xAllocFromBin(xBin bin)
 {
-  register xPage page = bin->currentPage;
+  xPage page = bin->currentPage;
+  void *addr;
   if ((page!=NULL) && (page->current != NULL))
-    return xAllocFromNonEmptyPage(page);
+  {
+    addr  = xAllocFromNonEmptyPage(page);
+    // blocks are handed out in ascending order from a fresh page, the next
+    // untouched one is the new head of its free list
+    if (addr == bin->zero)
+      bin->zero = page->current;
+    return addr;
+  }
   else
     return xAllocFromFullPage(bin);
 }
 
+/**
+ * \fn static inline void* xAlloc0SizeFromBin(xBin bin, const size_t size)
+ *
+ * \brief Memory allocation from \c bin , the first \c size bytes are set
+ * to zero. A block never handed out from a page fresh from the system is zero
+ * already but for its link in the free list, so no memset is needed.
+ *
+ * \param bin \c xBin the bin memory should be allocated from
+ *
+ * \param size number of bytes to set to zero, at most the block size of
+ * \c bin
+ *
+ * \return address of allocated memory
+ *
+ */
+static inline void* xAlloc0SizeFromBin(xBin bin, const size_t size)
+{
+  void *zero  = bin->zero;
+  void *addr  = xAllocFromBin(bin);
+  if (addr == zero)
+    *((void **) addr) = NULL;
+  else
+    memset(addr, 0, size);
+  return addr;
+}
+
 /**
  * \fn static inline void xAlloc0FromBin(xBin bin)
  *
@@ -440,8 +478,12 @@ static inline void* xAllocFromBin(xBin bin)
  */
 static inline void* xAlloc0FromBin(xBin bin)
 {
+  void *zero  = bin->zero;
   void *addr  = xAllocFromBin(bin);
-  memset(addr, 0, bin->sizeInWords * __XMALLOC_SIZEOF_ALIGNMENT);
+  if (addr == zero)
+    *((void **) addr) = NULL;
+  else
+    xZeroBlock(addr, bin->sizeInWords);
   return addr;
 }
 
@@ -465,14 +507,15 @@ static inline void* xAlloc0FromBin(xBin bin)
  */
 static inline unsigned long xGetStickyOfPage(xPage page)
 {
-  return (((unsigned long) page->bin) &
-      (unsigned long) __XMALLOC_SIZEOF_VOIDP_MINUS_ONE);
+  return ((xBin) page->bin)->sticky;
 }
 
 /**
  * \fn static inline void xSetTopBinAndStickyOfPage(xPage page, xBin bin)
  *
- * \brief Set top bin and sticky bin of the page \c page .
+ * \brief Set top bin and sticky bin of the page \c page . The page header
+ * holds the exact bin owning the page, sticky or not, so getting it back is a
+ * single load.
  *
  * \param page \c xPage .
  *
@@ -481,8 +524,7 @@ static inline unsigned long xGetStickyOfPage(xPage page)
  */
 static inline void xSetTopBinAndStickyOfPage(xPage page, xBin bin)
 {
-  page->bin = (void *)(((unsigned long)bin->sticky & (__XMALLOC_SIZEOF_VOIDP - 1))
-                  + (unsigned long)bin);
+  page->bin = bin;
 }
 
 /**
@@ -497,7 +539,7 @@ static inline void xSetTopBinAndStickyOfPage(xPage page, xBin bin)
  */
 static inline void xSetTopBinOfPage(xPage page, xBin bin)
 {
-  page->bin = (void *)((unsigned long)bin + xGetStickyOfPage(page));
+  page->bin = bin;
 }
 
 /**
@@ -515,14 +557,14 @@ static inline xBin xGetTopBinOfPage(const xPage page)
 #if __XMALLOC_DEBUG > 1
   printf("page %p -- gtpoba %p\n", page, page->bin);
 #endif
-  return (xBin) (((unsigned long) page->bin) &
-      ~((unsigned long) __XMALLOC_SIZEOF_VOIDP_MINUS_ONE));
+  return (xBin) page->bin;
 }
 
 /**
  * \fn static inline void xSetStickyOfPage(xPage page, xBin sBin)
  *
- * \brief Sets sticky bin of \c page .
+ * \brief Sets sticky bin of \c page , i.e. \c page belongs to \c sBin
+ * afterwards.
  *
  * \param page \c xPage
  *
@@ -531,30 +573,23 @@ static inline xBin xGetTopBinOfPage(const xPage page)
  */
 static inline void xSetStickyOfPage(xPage page, xBin bin)
 {
-  page->bin = (void *)(((unsigned long)bin->sticky
-                          & ((unsigned long)__XMALLOC_SIZEOF_VOIDP - 1)) +
-                        (unsigned long)xGetTopBinOfPage(page));
+  page->bin = bin;
 }
 
 /**
  * \fn static inline xBin xGetBinOfPage(const xPage page)
  *
- * \brief Get top bin the page \c page .
+ * \brief Get the bin owning the page \c page , sticky or not. This is one
+ * load, independent of the number of sticky bins of its size.
  *
  * \param page Const \c xPage .
  *
- * \return top \c xBin of \c xPage \c page
+ * \return \c xBin of \c xPage \c page
  *
  */
 static inline xBin xGetBinOfPage(const xPage page)
 {
-  unsigned long sticky  = xGetStickyOfPage(page);
-  xBin bin              = xGetTopBinOfPage(page);
-  if (!xIsStickyBin(bin))
-    while ((bin->sticky != sticky) && (NULL != bin->next))
-      bin = bin->next;
-
-  return bin;
+  return (xBin) page->bin;
 }
 
 /**
@@ -584,7 +619,98 @@ static inline xBin xGetBinOfAddr(void *addr)
  */
 static inline void xSetBinOfPage(xPage page, xBin bin)
 {
-  page->bin = (void *)((unsigned long)bin + xGetStickyOfPage(page));
+  page->bin = bin;
+}
+
+/************************************************
+ * ALLOCATING NEAR OTHER BLOCKS
+ ***********************************************/
+/**
+ * \brief Number of pages behind the current one of a bin which are searched
+ * for a page in the region of the hint of \c xAllocFromBinNear() .
+ */
+#define __XMALLOC_NEAR_SEARCH_PAGES   8
+
+/**
+ * \fn void xAllocFromPageFault(xPage page, xBin bin)
+ *
+ * \brief Takes care of \c page of \c bin which got full without being the
+ * current page of \c bin : It is moved in front of the current page as the
+ * pages which were current before, otherwise \c xAllocFromFullPage() would
+ * pick it up.
+ *
+ * \param page \c xPage full
+ *
+ * \param bin \c xBin \c page belongs to
+ *
+ */
+void xAllocFromPageFault(xPage page, xBin bin);
+
+/**
+ * \fn void* xAllocFromBinNearRegion(xBin bin, xRegion region)
+ *
+ * \brief Allocates a block of \c bin , from a page in \c region if the
+ * current page or one of the __XMALLOC_NEAR_SEARCH_PAGES pages behind it is
+ * in there.
+ *
+ * \param bin \c xBin the block is allocated from
+ *
+ * \param region \c xRegion preferred
+ *
+ * \return address of allocated memory
+ *
+ */
+void* xAllocFromBinNearRegion(xBin bin, xRegion region);
+
+/**
+ * \fn static inline void* xAllocFromPageOfBin(xPage page, xBin bin)
+ *
+ * \brief Allocates a block of \c bin from \c page , which need not be the
+ * current page of \c bin .
+ *
+ * \param page \c xPage of \c bin with free blocks
+ *
+ * \param bin \c xBin \c page belongs to
+ *
+ * \return address of allocated memory
+ *
+ */
+static inline void* xAllocFromPageOfBin(xPage page, xBin bin)
+{
+  void *addr  = xAllocFromNonEmptyPage(page);
+  if (addr == bin->zero)
+    bin->zero = page->current;
+  if (NULL == page->current && page != bin->currentPage)
+    xAllocFromPageFault(page, bin);
+  return addr;
+}
+
+/**
+ * \fn static inline void* xAllocFromBinNear(xBin bin, const void *hint)
+ *
+ * \brief Allocates a block of \c bin on the page of \c hint if this page
+ * belongs to \c bin and has free blocks, else preferably on a page of the
+ * same region. Blocks traversed one after the other, e.g. the ones of a
+ * linked list, share pages and cache lines this way.
+ *
+ * \param bin \c xBin the block is allocated from
+ *
+ * \param hint address of a block allocated by xmalloc, or NULL
+ *
+ * \return address of allocated memory
+ *
+ */
+static inline void* xAllocFromBinNear(xBin bin, const void *hint)
+{
+  xPage page;
+  if (NULL != hint && xIsBinAddr(hint))
+  {
+    page  = xGetPageOfBinAddr(hint);
+    if (xGetBinOfPage(page) == bin && NULL != page->current)
+      return xAllocFromPageOfBin(page, bin);
+    return xAllocFromBinNearRegion(bin, page->region);
+  }
+  return xAllocFromBin(bin);
 }
 
 /**
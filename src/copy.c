@@ -0,0 +1,123 @@
+/**
+ * \file   copy.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Copy and zero kernels for the block sizes of the static bins, see
+ *         copy.h.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include "src/copy.h"
+
+/* the loops must not be turned into calls of memcpy() and memset() again */
+#if defined(__GNUC__) && !defined(__clang__)
+#define __XMALLOC_KERNEL                                                \
+  __attribute__ ((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define __XMALLOC_KERNEL
+#endif
+
+/* kernels of a constant number of words, the compiler unrolls them; words
+ * is only passed to keep the signature of the tables */
+#define __XMALLOC_COPY_KERNEL(n)                                        \
+  static __XMALLOC_KERNEL void xCopyWords##n(void *dst, const void *src,\
+                                             size_t words)              \
+  {                                                                     \
+    (void) words;                                                       \
+    xCopyWords(dst, src, n);                                            \
+  }                                                                     \
+  static __XMALLOC_KERNEL void xZeroWords##n(void *dst, size_t words)   \
+  {                                                                     \
+    (void) words;                                                       \
+    xZeroWords(dst, n);                                                 \
+  }
+
+/* kernels of any other number of words, e.g. blocks of special bins or
+ * parts of blocks */
+static __XMALLOC_KERNEL void xCopyWordsAny(void *dst, const void *src,
+                                           size_t words)
+{
+  xCopyWords(dst, src, words);
+}
+
+static __XMALLOC_KERNEL void xZeroWordsAny(void *dst, size_t words)
+{
+  xZeroWords(dst, words);
+}
+
+__XMALLOC_COPY_KERNEL(5)
+__XMALLOC_COPY_KERNEL(6)
+__XMALLOC_COPY_KERNEL(7)
+__XMALLOC_COPY_KERNEL(8)
+__XMALLOC_COPY_KERNEL(9)
+__XMALLOC_COPY_KERNEL(10)
+__XMALLOC_COPY_KERNEL(12)
+__XMALLOC_COPY_KERNEL(14)
+__XMALLOC_COPY_KERNEL(16)
+__XMALLOC_COPY_KERNEL(18)
+__XMALLOC_COPY_KERNEL(20)
+__XMALLOC_COPY_KERNEL(24)
+__XMALLOC_COPY_KERNEL(28)
+
+const xCopyKernelFunc xCopyKernel[__XMALLOC_NUMBER_COPY_KERNELS] = {
+xCopyWordsAny,     /*    0 */
+xCopyWordsAny,     /*    8 */
+xCopyWordsAny,     /*   16 */
+xCopyWordsAny,     /*   24 */
+xCopyWordsAny,     /*   32 */
+xCopyWords5,       /*   40 */
+xCopyWords6,       /*   48 */
+xCopyWords7,       /*   56 */
+xCopyWords8,       /*   64 */
+xCopyWords9,       /*   72 */
+xCopyWords10,      /*   80 */
+xCopyWordsAny,     /*   88 */
+xCopyWords12,      /*   96 */
+xCopyWordsAny,     /*  104 */
+xCopyWords14,      /*  112 */
+xCopyWordsAny,     /*  120 */
+xCopyWords16,      /*  128 */
+xCopyWordsAny,     /*  136 */
+xCopyWords18,      /*  144 */
+xCopyWordsAny,     /*  152 */
+xCopyWords20,      /*  160 */
+xCopyWordsAny,     /*  168 */
+xCopyWordsAny,     /*  176 */
+xCopyWordsAny,     /*  184 */
+xCopyWords24,      /*  192 */
+xCopyWordsAny,     /*  200 */
+xCopyWordsAny,     /*  208 */
+xCopyWordsAny,     /*  216 */
+xCopyWords28       /*  224 */};
+
+const xZeroKernelFunc xZeroKernel[__XMALLOC_NUMBER_COPY_KERNELS] = {
+xZeroWordsAny,     /*    0 */
+xZeroWordsAny,     /*    8 */
+xZeroWordsAny,     /*   16 */
+xZeroWordsAny,     /*   24 */
+xZeroWordsAny,     /*   32 */
+xZeroWords5,       /*   40 */
+xZeroWords6,       /*   48 */
+xZeroWords7,       /*   56 */
+xZeroWords8,       /*   64 */
+xZeroWords9,       /*   72 */
+xZeroWords10,      /*   80 */
+xZeroWordsAny,     /*   88 */
+xZeroWords12,      /*   96 */
+xZeroWordsAny,     /*  104 */
+xZeroWords14,      /*  112 */
+xZeroWordsAny,     /*  120 */
+xZeroWords16,      /*  128 */
+xZeroWordsAny,     /*  136 */
+xZeroWords18,      /*  144 */
+xZeroWordsAny,     /*  152 */
+xZeroWords20,      /*  160 */
+xZeroWordsAny,     /*  168 */
+xZeroWordsAny,     /*  176 */
+xZeroWordsAny,     /*  184 */
+xZeroWords24,      /*  192 */
+xZeroWordsAny,     /*  200 */
+xZeroWordsAny,     /*  208 */
+xZeroWordsAny,     /*  216 */
+xZeroWords28       /*  224 */};
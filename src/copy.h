@@ -0,0 +1,195 @@
+/**
+ * \file   copy.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Copy and zero kernels for blocks of bins. Blocks are multiples of
+ *         __XMALLOC_SIZEOF_ALIGNMENT bytes, so small ones are copied and
+ *         cleared word by word without the length dispatch of memcpy() and
+ *         memset(). Tiny blocks are handled inline, for each block size of
+ *         the static bins up to __XMALLOC_MAX_COPY_KERNEL_SIZE there is a
+ *         kernel with a constant number of words in xCopyKernel[] resp.
+ *         xZeroKernel[], larger blocks are left to memcpy() and memset().
+ *         The kernels use SSE2 if configure detected it, see AX_EXT, and
+ *         AVX2 if the compiler is told to use it, e.g. by CFLAGS=-mavx2.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_COPY_H
+#define XMALLOC_COPY_H
+
+#include <stdint.h>
+#include <string.h>
+#include "xmalloc-config.h"
+
+#if __XMALLOC_SIZEOF_ALIGNMENT == 8
+#if defined(__XMALLOC_HAVE_SSE2) && defined(__SSE2__)
+#define __XMALLOC_COPY_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__XMALLOC_COPY_SSE2) && defined(__AVX2__)
+#define __XMALLOC_COPY_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+/**
+ * \brief Blocks of at most this many words are copied and cleared inline.
+ */
+#define __XMALLOC_COPY_INLINE_WORDS   4
+
+/**
+ * \brief Blocks of at most this many bytes are copied and cleared by the
+ * kernels, for larger ones memcpy() and memset() are faster, see
+ * copy-block of bench-micro.
+ */
+#define __XMALLOC_MAX_COPY_KERNEL_SIZE  224
+
+/**
+ * \brief Number of entries of xCopyKernel[] and xZeroKernel[], they are
+ * indexed by the number of words of a block.
+ */
+#define __XMALLOC_NUMBER_COPY_KERNELS                                   \
+  (__XMALLOC_MAX_COPY_KERNEL_SIZE / __XMALLOC_SIZEOF_ALIGNMENT + 1)
+
+/**
+ * \brief Unit of blocks, it may alias any type stored in them.
+ */
+#if __XMALLOC_SIZEOF_ALIGNMENT == 8
+typedef uint64_t __attribute__ ((__may_alias__)) xWord;
+#else
+typedef uint32_t __attribute__ ((__may_alias__)) xWord;
+#endif
+
+typedef void (*xCopyKernelFunc)(void *dst, const void *src, size_t words);
+typedef void (*xZeroKernelFunc)(void *dst, size_t words);
+
+extern const xCopyKernelFunc xCopyKernel[];
+extern const xZeroKernelFunc xZeroKernel[];
+
+/**
+ * \fn static inline void xCopyWords(void *dst, const void *src,
+ *      size_t words)
+ *
+ * \brief Copies \c words words from \c src to \c dst . This is the body of
+ * the kernels, for a constant \c words the compiler unrolls it completely.
+ *
+ * \param dst address aligned to __XMALLOC_SIZEOF_ALIGNMENT
+ *
+ * \param src address aligned to __XMALLOC_SIZEOF_ALIGNMENT , the memory
+ * must not overlap with the one at \c dst
+ *
+ * \param words number of words to copy
+ *
+ */
+static inline void xCopyWords(void *dst, const void *src, size_t words)
+{
+  xWord *d        = (xWord *) dst;
+  const xWord *s  = (const xWord *) src;
+#ifdef __XMALLOC_COPY_AVX2
+  for (; words >= 4; words -= 4, d += 4, s += 4)
+    _mm256_storeu_si256((__m256i *) d,
+                        _mm256_loadu_si256((const __m256i *) s));
+#endif
+#ifdef __XMALLOC_COPY_SSE2
+  for (; words >= 2; words -= 2, d += 2, s += 2)
+    _mm_storeu_si128((__m128i *) d, _mm_loadu_si128((const __m128i *) s));
+#endif
+  for (; words > 0; words--)
+    *d++  = *s++;
+}
+
+/**
+ * \fn static inline void xZeroWords(void *dst, size_t words)
+ *
+ * \brief Sets \c words words at \c dst to zero. This is the body of the
+ * kernels, for a constant \c words the compiler unrolls it completely.
+ *
+ * \param dst address aligned to __XMALLOC_SIZEOF_ALIGNMENT
+ *
+ * \param words number of words to set to zero
+ *
+ */
+static inline void xZeroWords(void *dst, size_t words)
+{
+  xWord *d  = (xWord *) dst;
+#ifdef __XMALLOC_COPY_AVX2
+  for (; words >= 4; words -= 4, d += 4)
+    _mm256_storeu_si256((__m256i *) d, _mm256_setzero_si256());
+#endif
+#ifdef __XMALLOC_COPY_SSE2
+  for (; words >= 2; words -= 2, d += 2)
+    _mm_storeu_si128((__m128i *) d, _mm_setzero_si128());
+#endif
+  for (; words > 0; words--)
+    *d++  = 0;
+}
+
+/**
+ * \fn static inline void xCopyBlock(void *dst, const void *src,
+ *      size_t words)
+ *
+ * \brief Copies \c words words from \c src to \c dst , e.g. the contents of a
+ * block of a bin of \c words words.
+ *
+ * \param dst address aligned to __XMALLOC_SIZEOF_ALIGNMENT
+ *
+ * \param src address aligned to __XMALLOC_SIZEOF_ALIGNMENT , the memory
+ * must not overlap with the one at \c dst
+ *
+ * \param words number of words to copy
+ *
+ */
+static inline void xCopyBlock(void *dst, const void *src, size_t words)
+{
+  xWord *d        = (xWord *) dst;
+  const xWord *s  = (const xWord *) src;
+  if (words <= __XMALLOC_COPY_INLINE_WORDS)
+  {
+    switch (words)
+    {
+      case 4: d[3] = s[3]; /* fall through */
+      case 3: d[2] = s[2]; /* fall through */
+      case 2: d[1] = s[1]; /* fall through */
+      case 1: d[0] = s[0]; /* fall through */
+      default: break;
+    }
+  }
+  else if (words < __XMALLOC_NUMBER_COPY_KERNELS)
+    xCopyKernel[words](dst, src, words);
+  else
+    memcpy(dst, src, words << __XMALLOC_LOG_SIZEOF_ALIGNMENT);
+}
+
+/**
+ * \fn static inline void xZeroBlock(void *dst, size_t words)
+ *
+ * \brief Sets \c words words at \c dst to zero, e.g. a block of a bin of
+ * \c words words.
+ *
+ * \param dst address aligned to __XMALLOC_SIZEOF_ALIGNMENT
+ *
+ * \param words number of words to set to zero
+ *
+ */
+static inline void xZeroBlock(void *dst, size_t words)
+{
+  xWord *d  = (xWord *) dst;
+  if (words <= __XMALLOC_COPY_INLINE_WORDS)
+  {
+    switch (words)
+    {
+      case 4: d[3] = 0; /* fall through */
+      case 3: d[2] = 0; /* fall through */
+      case 2: d[1] = 0; /* fall through */
+      case 1: d[0] = 0; /* fall through */
+      default: break;
+    }
+  }
+  else if (words < __XMALLOC_NUMBER_COPY_KERNELS)
+    xZeroKernel[words](dst, words);
+  else
+    memset(dst, 0, words << __XMALLOC_LOG_SIZEOF_ALIGNMENT);
+}
+
+#endif
@@ -82,6 +82,13 @@ struct xRegionStruct;
 typedef struct xRegionStruct  xRegionType;
 typedef xRegionType*          xRegion;
 
+struct xArenaStruct;
+typedef struct xArenaStruct   xArenaType;
+typedef xArenaType*           xArena;
+
+struct xArenaMarkStruct;
+typedef struct xArenaMarkStruct xArenaMarkType;
+
 /**
  * \struct xMutexStruct
  *
@@ -127,23 +134,27 @@ struct xBinStruct {
   xBin    next;         /**< Next page in the free list of this size class */
   size_t  sizeInWords;  /**< Size class in word size */
   long    numberBlocks; /**< Maximum number of blocks per page w.r.t. the size 
-                             class: If > 0 => \#blocks per page
+                             class: If > 0 => \#blocks per page, which
+                                    spans xPagesOfBin() system pages
                                     If < 0 => \#pages per block */
   unsigned long sticky; /**< sticky tag of bin */
+  void*   zero;         /**< Lowest block of the page allocated last for this
+                             bin which was never handed out: it and the
+                             blocks behind it are still zero but for their
+                             link in the free list. NULL if unknown */
 };
 
 /**
  * \struct xSpecBinStruct
  *
- * \brief Bin structure eSPECially for monomials.
+ * \brief Bin structure eSPECially for monomials. The bin is the first member,
+ * so the \c xBin of a spec bin is the spec bin itself. Both fit into one cache
+ * line, spec bins are registered in xSpecBinTable by
+ * \c bin.numberBlocks and \c bin.sizeInWords .
  */
 struct xSpecBinStruct {
-  xSpecBin  next;           /**< pointer to next bin */
-  xBin      bin;            /**< pointer to bin itself */
-  long      numberBlocks;   /**< Maximum number of blocks per page w.r.t.
-                              the size class: If > 0 => \#blocks per page
-                                              If < 0 => \#pages per block */
-  long      ref;            /** reference counter */
+  xBinType  bin;            /**< bin itself */
+  long      ref;            /**< reference counter */
 };
 
 /**
@@ -167,6 +178,33 @@ struct xRegionStruct {
 };
 
 
+/**
+ * \struct xArenaStruct
+ *
+ * \brief Arena of objects which are freed all at once. Objects are bumped
+ * one after the other into pages of the regions, there are neither headers
+ * nor free lists. The pages of an arena are linked by \c prev starting at
+ * the one allocated last, they belong to \c __XMALLOC_ARENA_BIN .
+ */
+struct xArenaStruct {
+  xPage lastPage;       /**< page allocated last for this arena */
+  char* current;        /**< next free byte in the page small objects are
+                             bumped into */
+  char* end;            /**< end of the page small objects are bumped into */
+};
+
+/**
+ * \struct xArenaMarkStruct
+ *
+ * \brief State of an arena returned by \c xArenaMark() , everything
+ * allocated afterwards is freed by \c xArenaRelease() .
+ */
+struct xArenaMarkStruct {
+  xPage lastPage;       /**< page allocated last for the arena */
+  char* current;        /**< next free byte in the page of small objects */
+  char* end;            /**< end of the page of small objects */
+};
+
 /**
  * \struct xInfoStruct
  *
@@ -197,6 +235,53 @@ struct xInfoStruct {
 
 typedef struct xInfoStruct xInfo;
 
+/**
+ * \brief Number of sub-buckets per power of two in an \c xHistogram , i.e.
+ * recorded values are exact up to 1/__XMALLOC_HISTOGRAM_SUB_BUCKETS.
+ */
+#define __XMALLOC_LOG_HISTOGRAM_SUB_BUCKETS 4
+#define __XMALLOC_HISTOGRAM_SUB_BUCKETS     (1 << __XMALLOC_LOG_HISTOGRAM_SUB_BUCKETS)
+/**
+ * \brief Largest power of two distinguished by an \c xHistogram , larger
+ * values are counted in the last bucket.
+ */
+#define __XMALLOC_LOG_HISTOGRAM_MAX_VALUE   48
+#define __XMALLOC_HISTOGRAM_BUCKETS                                   \
+  ((__XMALLOC_LOG_HISTOGRAM_MAX_VALUE -                               \
+    __XMALLOC_LOG_HISTOGRAM_SUB_BUCKETS + 1) *                        \
+   __XMALLOC_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * \brief Slow paths of xmalloc whose latencies are recorded if xmalloc is
+ * configured with --enable-histograms.
+ */
+enum xLatency_e {
+  xLatency_NewPageForBin = 0, /**< xAllocNewPageForBin() */
+  xLatency_NewRegion,         /**< xAllocNewRegion() */
+  xLatency_ConsecutivePages,  /**< xGetConsecutivePagesFromRegion() */
+  xLatency_PageIndexFault,    /**< xPageIndexFault() */
+  xLatency_LargeSystem,       /**< system malloc() for large blocks */
+  xLatency_MaxKind
+};
+
+struct xHistogramStruct;
+typedef struct xHistogramStruct xHistogramType;
+typedef xHistogramType*         xHistogram;
+
+/**
+ * \struct xHistogramStruct
+ *
+ * \brief Log-bucketed histogram in the style of HdrHistogram: Each power of
+ * two is split into \c __XMALLOC_HISTOGRAM_SUB_BUCKETS linear sub-buckets.
+ */
+struct xHistogramStruct {
+  unsigned long long count;   /**< number of recorded values */
+  unsigned long long sum;     /**< sum of recorded values */
+  unsigned long long min;     /**< minimal recorded value */
+  unsigned long long max;     /**< maximal recorded value */
+  unsigned long long buckets[__XMALLOC_HISTOGRAM_BUCKETS]; /**< counters */
+};
+
 struct xOptsStruct;
 extern struct xOpts_s {
   int MinTrack;
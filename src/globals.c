@@ -14,9 +14,12 @@
 #include <limits.h>
 #include "src/data.h"
 #include "src/globals.h"
+#include "src/histogram.h"
 
 // extern declaration in globals.h --- start
-xSpecBin xBaseSpecBin     = NULL;
+xSpecBin *xSpecBinTable           = NULL;
+unsigned long xSpecBinTableSize   = 0;
+unsigned long xNumberSpecBins     = 0;
 xBin __XMALLOC_LARGE_BIN  = (xBin) 1;
 
 struct __attribute__ ((aligned(__XMALLOC_SIZEOF_CACHELINE))) xBinStruct xStaticBin[/*23*/] = {
@@ -175,12 +178,27 @@ xBin xSize2Bin[/*126*/] = {
 
 xBin xStickyBins  = NULL;
 
+xBin xAlignedBin[__XMALLOC_LOG_BIT_SIZEOF_SYSTEM_PAGE - 5]
+                [__XMALLOC_NUMBER_ALIGNED_BINS];
+
 
 /************************************
  * STATISTICS / XINFO STUFF
  ***********************************/
 xInfo info  = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
+struct xHistogramStruct xLatency[xLatency_MaxKind];
+
+#ifdef __XMALLOC_HISTOGRAMS
+static const char *xLatencyName[xLatency_MaxKind] = {
+  "NewPageForBin:",
+  "NewRegion:",
+  "ConsecutivePages:",
+  "PageIndexFault:",
+  "LargeSystem:"
+};
+#endif
+
 void xUpdateInfo() {
   if (info.currentBytesFromMalloc < 0)
     info.currentBytesFromMalloc = 0;
@@ -202,6 +220,15 @@ void xPrintInfo() {
   printf("BytesMalloc:     %8ldk  %8ldk\n", info.usedBytesMalloc/1024, info.availableBytesMalloc/1024);
   printf("BytesValloc:     %8ldk  %8ldk\n", info.usedBytesFromValloc/1024, info.availableBytesFromValloc/1024);
   printf("Pages:           %8ld   %8ld\n", info.usedPages, info.availablePages);
+#ifdef __XMALLOC_HISTOGRAMS
+  {
+    int i;
+    printf("Latencies:            Count:      Mean:       p50:       p90:"
+        "       p99:     p99.9:       Max:\n");
+    for (i = 0; i < xLatency_MaxKind; i++)
+      xPrintHistogram(stdout, xLatencyName[i], &xLatency[i]);
+  }
+#endif
 }
 // extern declaration in globals.h --- end
 /************************************************
@@ -10,22 +10,40 @@
 #ifndef XMALLOC_GLOBALS_H
 #define XMALLOC_GLOBALS_H
 
+#include "xmalloc-config.h"
+
 #define X_XMALLOC
 
 extern xPage xPageForMalloc;
-extern xSpecBin xBaseSpecBin;
+/* open addressing hash table of the spec bins, see xFindSpecBin() */
+extern xSpecBin *xSpecBinTable;
+extern unsigned long xSpecBinTableSize;
+extern unsigned long xNumberSpecBins;
 extern xRegion xBaseRegion;
+/* number of regions without used pages, they stay mapped up to
+ * __XMALLOC_MAX_EMPTY_REGIONS */
+extern unsigned long xNumberEmptyRegions;
 /* zero page for initializing static bins */
 extern struct xPageStruct __XMALLOC_ZERO_PAGE[];
+/* bin owning the pages of arenas, it has no blocks */
+extern struct xBinStruct __XMALLOC_ARENA_BIN[];
 
 extern unsigned long xMinPageIndex;
 extern unsigned long xMaxPageIndex;
 extern unsigned long *xPageShifts;
+/* pages of spans behind their first one, indexed as xPageShifts */
+extern unsigned long *xSpanShifts;
 
 extern struct xBinStruct xStaticBin[];
 
 extern xBin xStickyBins;
 
+/* bins of blocks aligned to 32 bytes and more, created by xGetAlignedBin():
+ * xAlignedBin[log2(alignment) - 5][(size - 1) / alignment] */
+#define __XMALLOC_NUMBER_ALIGNED_BINS                               \
+  ((__XMALLOC_MAX_SMALL_BLOCK_SIZE + 31) >> 5)
+extern xBin xAlignedBin[][__XMALLOC_NUMBER_ALIGNED_BINS];
+
 //extern size_t xCacheLineSize;
 
 /********************************************
@@ -39,6 +57,9 @@ extern int xIsThreaded;
  *******************************************/
 extern xInfo info;
 
+/* latency histograms of the slow paths, see enum xLatency_e */
+extern struct xHistogramStruct xLatency[];
+
 void xPrintInfo();
 void xUpdateInfo();
 
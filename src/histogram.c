@@ -0,0 +1,75 @@
+/**
+ * \file   histogram.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Source file for non-inline latency histogram functions.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "src/histogram.h"
+
+void xHistogramReset(xHistogram histogram)
+{
+  memset(histogram, 0, sizeof(xHistogramType));
+}
+
+unsigned long long xHistogramPercentile(const xHistogramType *histogram,
+    double percentile)
+{
+  unsigned long long rank, seen = 0, value;
+  unsigned int i;
+
+  if (0 == histogram->count)
+    return 0;
+  if (percentile <= 0.0)
+    return histogram->min;
+  if (percentile >= 100.0)
+    return histogram->max;
+
+  rank  = (unsigned long long) (percentile / 100.0 * histogram->count + 0.5);
+  if (0 == rank)
+    rank  = 1;
+  for (i = 0; i < __XMALLOC_HISTOGRAM_BUCKETS; i++)
+  {
+    seen  +=  histogram->buckets[i];
+    if (seen >= rank)
+    {
+      // highest value equivalent to bucket i
+      value = (i + 1 < __XMALLOC_HISTOGRAM_BUCKETS ?
+                xHistogramValueOfBucket(i + 1) - 1 : histogram->max);
+      return __XMALLOC_MIN(value, histogram->max);
+    }
+  }
+  return histogram->max;
+}
+
+void xPrintHistogram(FILE *file, const char *name,
+    const xHistogramType *histogram)
+{
+  double ticksPerNs;
+  if (0 == histogram->count)
+  {
+    fprintf(file, "%-18s %10d\n", name, 0);
+    return;
+  }
+  ticksPerNs  = xTscTicksPerNanosecond();
+  fprintf(file, "%-18s %10llu %10.0f %10llu %10llu %10llu %10llu %10llu  ticks\n",
+      name, histogram->count,
+      (double) histogram->sum / histogram->count,
+      xHistogramPercentile(histogram, 50.0),
+      xHistogramPercentile(histogram, 90.0),
+      xHistogramPercentile(histogram, 99.0),
+      xHistogramPercentile(histogram, 99.9),
+      histogram->max);
+  fprintf(file, "%-18s %10s %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f  ns\n",
+      "", "",
+      (double) histogram->sum / histogram->count / ticksPerNs,
+      xHistogramPercentile(histogram, 50.0) / ticksPerNs,
+      xHistogramPercentile(histogram, 90.0) / ticksPerNs,
+      xHistogramPercentile(histogram, 99.0) / ticksPerNs,
+      xHistogramPercentile(histogram, 99.9) / ticksPerNs,
+      histogram->max / ticksPerNs);
+}
@@ -0,0 +1,149 @@
+/**
+ * \file   histogram.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Log-bucketed latency histograms for xmalloc. If xmalloc is
+ *         configured with --enable-histograms, the time stamp counter ticks
+ *         spent in the slow paths listed in \c xLatency_e are recorded in
+ *         \c xLatency[] and printed by \c xPrintInfo() .
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_HISTOGRAM_H
+#define XMALLOC_HISTOGRAM_H
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "data.h"
+#include "globals.h"
+#include "tsc.h"
+
+/**
+ * \fn static inline unsigned int xHistogramBucketOfValue(
+ * unsigned long long value)
+ *
+ * \brief Computes the bucket \c value is counted in.
+ *
+ * \param value \c unsigned \c long \c long value to be recorded
+ *
+ * \return index of the bucket
+ *
+ */
+static inline unsigned int xHistogramBucketOfValue(unsigned long long value)
+{
+  unsigned int log;
+  if (value < __XMALLOC_HISTOGRAM_SUB_BUCKETS)
+    return (unsigned int) value;
+  log = 63 - __builtin_clzll(value);
+  if (log >= __XMALLOC_LOG_HISTOGRAM_MAX_VALUE)
+    return __XMALLOC_HISTOGRAM_BUCKETS - 1;
+  return (log - __XMALLOC_LOG_HISTOGRAM_SUB_BUCKETS + 1) *
+          __XMALLOC_HISTOGRAM_SUB_BUCKETS +
+          (unsigned int) ((value >> (log - __XMALLOC_LOG_HISTOGRAM_SUB_BUCKETS))
+            & (__XMALLOC_HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ * \fn static inline unsigned long long xHistogramValueOfBucket(
+ * unsigned int bucket)
+ *
+ * \brief Computes the smallest value counted in \c bucket .
+ *
+ * \param bucket index of the bucket
+ *
+ * \return smallest value of \c bucket
+ *
+ */
+static inline unsigned long long xHistogramValueOfBucket(unsigned int bucket)
+{
+  unsigned int group  = bucket >> __XMALLOC_LOG_HISTOGRAM_SUB_BUCKETS;
+  unsigned int sub    = bucket & (__XMALLOC_HISTOGRAM_SUB_BUCKETS - 1);
+  if (0 == group)
+    return (unsigned long long) bucket;
+  return ((unsigned long long) (__XMALLOC_HISTOGRAM_SUB_BUCKETS + sub))
+          << (group - 1);
+}
+
+/**
+ * \fn static inline void xHistogramRecord(xHistogram histogram,
+ * unsigned long long value)
+ *
+ * \brief Records \c value in \c histogram .
+ *
+ * \param histogram \c xHistogram the value is recorded in
+ *
+ * \param value \c unsigned \c long \c long value to be recorded
+ *
+ */
+static inline void xHistogramRecord(xHistogram histogram,
+    unsigned long long value)
+{
+  if (0 == histogram->count || value < histogram->min)
+    histogram->min  = value;
+  if (value > histogram->max)
+    histogram->max  = value;
+  histogram->count++;
+  histogram->sum  +=  value;
+  histogram->buckets[xHistogramBucketOfValue(value)]++;
+}
+
+/**
+ * \fn void xHistogramReset(xHistogram histogram)
+ *
+ * \brief Removes all recorded values from \c histogram .
+ *
+ * \param histogram \c xHistogram to be reset
+ *
+ */
+void xHistogramReset(xHistogram histogram);
+
+/**
+ * \fn unsigned long long xHistogramPercentile(const xHistogramType
+ * *histogram, double percentile)
+ *
+ * \brief Computes the value below or at which \c percentile percent of the
+ * recorded values lie. The result is exact up to the sub-bucket resolution.
+ *
+ * \param histogram \c xHistogram to be evaluated
+ *
+ * \param percentile \c double between 0 and 100
+ *
+ * \return highest value equivalent to the percentile, 0 if \c histogram is
+ * empty
+ *
+ */
+unsigned long long xHistogramPercentile(const xHistogramType *histogram,
+    double percentile);
+
+/**
+ * \fn void xPrintHistogram(FILE *file, const char *name,
+ * const xHistogramType *histogram)
+ *
+ * \brief Prints count, mean, percentiles and maximum of \c histogram in time
+ * stamp ticks and nanoseconds.
+ *
+ * \param file \c FILE to print to
+ *
+ * \param name name of the histogram
+ *
+ * \param histogram \c xHistogram to be printed
+ *
+ */
+void xPrintHistogram(FILE *file, const char *name,
+    const xHistogramType *histogram);
+
+/************************************************
+ * MEASURING THE SLOW PATHS
+ ***********************************************/
+#ifdef __XMALLOC_HISTOGRAMS
+#define __XMALLOC_LATENCY_START(start)                                \
+  unsigned long long start = xReadTsc()
+#define __XMALLOC_LATENCY_STOP(kind, start)                           \
+  xHistogramRecord(&xLatency[kind], xReadTsc() - (start))
+#else
+#define __XMALLOC_LATENCY_START(start)
+#define __XMALLOC_LATENCY_STOP(kind, start) ((void) 0)
+#endif
+
+#endif
@@ -8,6 +8,9 @@
  */
 
 #include "src/page.h"
+#include "src/trace.h"
+#include "src/probes.h"
+#include "src/histogram.h"
 
 /* zero page for initializing static bins */
 struct xPageStruct __XMALLOC_ZERO_PAGE[] = {{0, NULL, NULL, NULL, NULL}};
@@ -15,6 +18,7 @@ struct xPageStruct __XMALLOC_ZERO_PAGE[] = {{0, NULL, NULL, NULL, NULL}};
 unsigned long xMinPageIndex = ULONG_MAX;
 unsigned long xMaxPageIndex = 0;
 unsigned long *xPageShifts = NULL;
+unsigned long *xSpanShifts = NULL;
 
 
 /**********************************************
@@ -26,15 +30,22 @@ void xPageIndexFault(unsigned long startIndex, unsigned long endIndex)
   long i;
   __XMALLOC_ASSERT((startIndex <= endIndex) &&
          (endIndex > xMaxPageIndex || startIndex < xMinPageIndex));
+  __XMALLOC_TRACE_EVENT(xTrace_PageIndexFault, startIndex, endIndex);
+  __XMALLOC_PROBE2(page__index__fault, startIndex, endIndex);
 
   if (NULL == xPageShifts)
   {
     xPageShifts   = (unsigned long *) xAllocFromSystem((indexDiff + 1) *
                         __XMALLOC_SIZEOF_LONG);
+    xSpanShifts   = (unsigned long *) xAllocFromSystem((indexDiff + 1) *
+                        __XMALLOC_SIZEOF_LONG);
     xMaxPageIndex = endIndex;
     xMinPageIndex = startIndex;
     for (i = 0; i <= indexDiff; i++)
+    {
       xPageShifts[i]  = 0;
+      xSpanShifts[i]  = 0;
+    }
   }
   else
   {
@@ -46,39 +57,47 @@ void xPageIndexFault(unsigned long startIndex, unsigned long endIndex)
     xPageShifts = (unsigned long *) xReallocSizeFromSystem(xPageShifts, // TOODOO
                                         oldLength * __XMALLOC_SIZEOF_LONG,
                                         newLength * __XMALLOC_SIZEOF_LONG);
+    xSpanShifts = (unsigned long *) xReallocSizeFromSystem(xSpanShifts,
+                                        oldLength * __XMALLOC_SIZEOF_LONG,
+                                        newLength * __XMALLOC_SIZEOF_LONG);
 
     if (startIndex < xMinPageIndex)
     {
       unsigned long offset  = newLength - oldLength;
       for (i = oldLength - 1; i >= 0; i--)
+      {
         xPageShifts[i + offset] = xPageShifts[i];
+        xSpanShifts[i + offset] = xSpanShifts[i];
+      }
       for (i = 0; i < offset; i++)
+      {
         xPageShifts[i]  = 0;
+        xSpanShifts[i]  = 0;
+      }
       xMinPageIndex = startIndex;
     } else {
       for (i = oldLength; i < newLength; i++)
+      {
         xPageShifts[i]  = 0;
+        xSpanShifts[i]  = 0;
+      }
       xMaxPageIndex = endIndex;
     }
   }
 }
 
-void xRegisterPagesInRegion(void *startAddr, int numberPages)
+/* sets the bits of numberPages pages from startAddr on in shifts, which is
+ * xPageShifts or xSpanShifts, the indices of the pages are valid */
+static void xSetPageBits(unsigned long *shifts, void *startAddr,
+    int numberPages)
 {
   char *endAddr = (char*) startAddr +
                     (numberPages - 1) * __XMALLOC_SIZEOF_SYSTEM_PAGE;
 
   unsigned long startIndex  = xGetPageIndexOfAddr(startAddr);
   unsigned long endIndex    = xGetPageIndexOfAddr(endAddr);
-  unsigned long shift;
-#if __XMALLOC_DEBUG > 1
-  printf("registering pages: %ld -- %ld\n",startIndex,endIndex);
-#endif
-  // check indices & correct them if necessary
-  if ((startIndex < xMinPageIndex) || (endIndex > xMaxPageIndex))
-    xPageIndexFault(startIndex, endIndex); // TOODOO
+  unsigned long shift       = xGetPageShiftOfAddr(startAddr);
 
-  shift = xGetPageShiftOfAddr(startAddr);
 #if __XMALLOC_DEBUG > 1
   printf("registering pages -- page shift: %ld\n", xGetPageShiftOfAddr(startAddr));
   printf("indices: %ld -- %ld\n", startIndex, endIndex);
@@ -86,16 +105,16 @@ void xRegisterPagesInRegion(void *startAddr, int numberPages)
   if (startIndex < endIndex)
   {
     if (0 == shift)
-      xPageShifts[startIndex - xMinPageIndex]  = ULONG_MAX;
+      shifts[startIndex - xMinPageIndex]  = ULONG_MAX;
     else
-      xPageShifts[startIndex - xMinPageIndex]  |= ~((((unsigned long) 1) << shift) - 1);
+      shifts[startIndex - xMinPageIndex]  |= ~((((unsigned long) 1) << shift) - 1);
     for (shift = startIndex + 1; shift < endIndex; shift++)
-      xPageShifts[shift - xMinPageIndex]  = ULONG_MAX;
+      shifts[shift - xMinPageIndex]  = ULONG_MAX;
     shift = xGetPageShiftOfAddr(endAddr);
     if ((__XMALLOC_BIT_SIZEOF_LONG - 1) == shift)
-      xPageShifts[endIndex - xMinPageIndex]  = ULONG_MAX;
+      shifts[endIndex - xMinPageIndex]  = ULONG_MAX;
     else
-      xPageShifts[endIndex - xMinPageIndex]  |=
+      shifts[endIndex - xMinPageIndex]  |=
         ((((unsigned long) 1) << (shift + 1)) - 1);
   }
   else
@@ -103,15 +122,17 @@ void xRegisterPagesInRegion(void *startAddr, int numberPages)
     endIndex  = xGetPageShiftOfAddr(endAddr);
     while (endIndex > shift)
     {
-      xPageShifts[startIndex - xMinPageIndex] |=
+      shifts[startIndex - xMinPageIndex] |=
         (((unsigned long) 1) << endIndex);
       endIndex--;
     }
-    xPageShifts[startIndex - xMinPageIndex] |= (((unsigned long) 1) << shift);
+    shifts[startIndex - xMinPageIndex] |= (((unsigned long) 1) << shift);
   }
 }
 
-void xUnregisterPagesFromRegion(void *startAddr, int numberPages) {
+/* clears the bits of numberPages pages from startAddr on in shifts */
+static void xClearPageBits(unsigned long *shifts, void *startAddr,
+    int numberPages) {
   unsigned long startIndex  = xGetPageIndexOfAddr(startAddr);
   char *endAddr             = (char *)startAddr +
                               (numberPages-1) * __XMALLOC_SIZEOF_SYSTEM_PAGE;
@@ -120,26 +141,68 @@ void xUnregisterPagesFromRegion(void *startAddr, int numberPages) {
 
   if (startIndex < endIndex) {
     if (0 == shift)
-      xPageShifts[startIndex - xMinPageIndex] =   0;
+      shifts[startIndex - xMinPageIndex] =   0;
     else
-      xPageShifts[startIndex - xMinPageIndex] &=  ((((unsigned long) 1) << shift) - 1);
+      shifts[startIndex - xMinPageIndex] &=  ((((unsigned long) 1) << shift) - 1);
 
     for (shift = startIndex + 1; shift < endIndex; shift++)
-      xPageShifts[shift - xMinPageIndex] = 0;
+      shifts[shift - xMinPageIndex] = 0;
 
     shift = xGetPageShiftOfAddr(endAddr);
     if ((__XMALLOC_BIT_SIZEOF_LONG - 1) == shift)
-      xPageShifts[endIndex - xMinPageIndex] =   0;
+      shifts[endIndex - xMinPageIndex] =   0;
     else
-      xPageShifts[endIndex - xMinPageIndex] &=
+      shifts[endIndex - xMinPageIndex] &=
           ~((((unsigned long) 1) << (shift + 1)) - 1);
   } else {
     // startIndex > endIndex
     endIndex  = xGetPageShiftOfAddr(endAddr);
     while (shift < endIndex) {
-      xPageShifts[startIndex - xMinPageIndex] &= ~(((unsigned long) 1) << endIndex);
+      shifts[startIndex - xMinPageIndex] &= ~(((unsigned long) 1) << endIndex);
       endIndex--;
     }
-    xPageShifts[startIndex - xMinPageIndex] &=  ~(((unsigned long) 1) << shift);
+    shifts[startIndex - xMinPageIndex] &=  ~(((unsigned long) 1) << shift);
+  }
+}
+
+void xRegisterPagesInRegion(void *startAddr, int numberPages)
+{
+  unsigned long startIndex  = xGetPageIndexOfAddr(startAddr);
+  unsigned long endIndex    = xGetPageIndexOfAddr((char *) startAddr +
+                                (numberPages - 1) *
+                                __XMALLOC_SIZEOF_SYSTEM_PAGE);
+#if __XMALLOC_DEBUG > 1
+  printf("registering pages: %ld -- %ld\n",startIndex,endIndex);
+#endif
+  // check indices & correct them if necessary
+  if ((startIndex < xMinPageIndex) || (endIndex > xMaxPageIndex))
+  {
+    __XMALLOC_LATENCY_START(start);
+    xPageIndexFault(startIndex, endIndex); // TOODOO
+    __XMALLOC_LATENCY_STOP(xLatency_PageIndexFault, start);
   }
+  xSetPageBits(xPageShifts, startAddr, numberPages);
+}
+
+void xUnregisterPagesFromRegion(void *startAddr, int numberPages) {
+  xClearPageBits(xPageShifts, startAddr, numberPages);
+}
+
+/**********************************************
+ * SPANS
+ *********************************************/
+void xRegisterSpanTail(xPage page, int numberPages)
+{
+  char *tail  = (char *) page + __XMALLOC_SIZEOF_SYSTEM_PAGE;
+  __XMALLOC_ASSERT(numberPages > 1);
+  xClearPageBits(xPageShifts, tail, numberPages - 1);
+  xSetPageBits(xSpanShifts, tail, numberPages - 1);
+}
+
+void xUnregisterSpanTail(xPage page, int numberPages)
+{
+  char *tail  = (char *) page + __XMALLOC_SIZEOF_SYSTEM_PAGE;
+  __XMALLOC_ASSERT(numberPages > 1);
+  xClearPageBits(xSpanShifts, tail, numberPages - 1);
+  xSetPageBits(xPageShifts, tail, numberPages - 1);
 }
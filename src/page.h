@@ -112,7 +112,7 @@ static inline xPage xGetPageOfBinAddr(const void *addr) {
  *
  */
 static inline int xIsBinAddr(const void *addr) {
-  register unsigned long testAddr = xGetPageIndexOfAddr(addr);
+  unsigned long testAddr = xGetPageIndexOfAddr(addr);
 #if __XMALLOC_DEBUG > 1
   printf("------!---------\n");
   printf("%ld\n",testAddr);
@@ -127,6 +127,46 @@ static inline int xIsBinAddr(const void *addr) {
           (((unsigned long) 1) << xGetPageShiftOfAddr(addr))) != 0));
 }
 
+/**
+ * \fn static inline int xIsSpanAddr(const void *addr)
+ *
+ * \brief Checks if \c addr is on a page of a span behind its first one.
+ * Only the first system page of a span is registered in xPageShifts, it holds
+ * the page header, so \c xIsBinAddr() is false for the others.
+ *
+ * \param addr Const pointer to the corresponding address
+ *
+ * \return true if \c addr is behind the first page of a span, false else
+ *
+ */
+static inline int xIsSpanAddr(const void *addr) {
+  unsigned long testAddr = xGetPageIndexOfAddr(addr);
+  return((testAddr >= xMinPageIndex) &&
+         (testAddr <= xMaxPageIndex) &&
+         ((xSpanShifts[testAddr - xMinPageIndex] &
+          (((unsigned long) 1) << xGetPageShiftOfAddr(addr))) != 0));
+}
+
+/**
+ * \fn static inline xPage xGetPageOfSpanAddr(const void *addr)
+ *
+ * \brief Gets the page of the block at \c addr , which is behind the first
+ * system page of its span, i.e. \c xIsSpanAddr(addr) is true. The span has
+ * at most __XMALLOC_MAX_SPAN_PAGES pages, so does the walk back.
+ *
+ * \param addr Const pointer to the corresponding address
+ *
+ * \return \c xPage \c addr is in
+ *
+ */
+static inline xPage xGetPageOfSpanAddr(const void *addr) {
+  char *page = (char *) xGetPageOfBinAddr(addr);
+  do
+    page  -=  __XMALLOC_SIZEOF_SYSTEM_PAGE;
+  while (!xIsBinAddr(page));
+  return (xPage) page;
+}
+
 /**
  * \fn static inline void xAllocFromNonEmptyPage(xPage page)
  *
@@ -189,6 +229,33 @@ void xRegisterPagesInRegion(void *startAddr, int numberPages);
  */
 void xUnregisterPagesFromRegion(void *startAddr, int numberPages);
 
+/**
+ * \fn void xRegisterSpanTail(xPage page, int numberPages)
+ *
+ * \brief Marks the system pages behind \c page in its span of
+ * \c numberPages pages as span pages: They are unregistered as \c xPages ,
+ * they hold no page header, but blocks which started on an earlier page.
+ *
+ * \param page \c xPage first page of the span, registered
+ *
+ * \param numberPages number of system pages of the span, at least 2
+ *
+ */
+void xRegisterSpanTail(xPage page, int numberPages);
+
+/**
+ * \fn void xUnregisterSpanTail(xPage page, int numberPages)
+ *
+ * \brief Undoes \c xRegisterSpanTail(page, numberPages) before the span is
+ * given back to its region.
+ *
+ * \param page \c xPage first page of the span
+ *
+ * \param numberPages number of system pages of the span, at least 2
+ *
+ */
+void xUnregisterSpanTail(xPage page, int numberPages);
+
 /************************************************
  * INLINED PAGE TESTS / ADDRESS HANDLINGS
  ***********************************************/
@@ -0,0 +1,343 @@
+/**
+ * \file   preload.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Drop-in replacement of the malloc family of the C library, built
+ *         as libxmalloc-preload.so:
+ *           LD_PRELOAD=/path/to/libxmalloc-preload.so ./prog
+ *         Small blocks are taken from the static bins of xmalloc, also
+ *         for alignments up to __XMALLOC_MAX_BIN_ALIGNMENT. Larger blocks
+ *         and blocks with a larger alignment come from the C library,
+ *         whose functions are resolved via dlsym(RTLD_NEXT, ...). free()
+ *         and realloc() distinguish both by xIsBinAddr(), so blocks the C
+ *         library allocated internally are handled, too.
+ *         As malloc() of the C library the functions return blocks aligned
+ *         to __XMALLOC_PRELOAD_ALIGNMENT. xmalloc is not thread-safe, all
+ *         calls into it are serialized by one global mutex.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <dlfcn.h>
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "src/xmalloc.h"
+
+/**
+ * \brief Alignment of all blocks returned, the one of the C library on the
+ * supported platforms.
+ */
+#define __XMALLOC_PRELOAD_ALIGNMENT   (2 * __XMALLOC_SIZEOF_VOIDP)
+
+/**
+ * \brief Size of the buffer serving allocations during the startup, i.e.
+ * while the functions of the C library are not resolved yet.
+ */
+#define __XMALLOC_PRELOAD_BOOTSTRAP_SIZE  4096
+
+void* (*xSystemMalloc)(size_t size)                     = NULL;
+void* (*xSystemRealloc)(void *addr, size_t size)        = NULL;
+void  (*xSystemFree)(void *addr)                        = NULL;
+void* (*xSystemMemalign)(size_t alignment, size_t size) = NULL;
+void* (*xSystemCalloc)(size_t number, size_t size)      = NULL;
+static size_t (*xSystemUsableSize)(void *addr)          = NULL;
+
+static pthread_mutex_t xPreloadMutex  = PTHREAD_MUTEX_INITIALIZER;
+static int xPreloadInitializing       = 0;
+
+/* bin for each size in units of __XMALLOC_PRELOAD_ALIGNMENT whose blocks
+ * keep the alignment */
+static xBin xPreloadBin[__XMALLOC_MAX_SMALL_BLOCK_SIZE /
+                        __XMALLOC_PRELOAD_ALIGNMENT + 1];
+
+static char xPreloadBootstrap[__XMALLOC_PRELOAD_BOOTSTRAP_SIZE]
+  __attribute__ ((aligned(__XMALLOC_PRELOAD_ALIGNMENT)));
+static size_t xPreloadBootstrapUsed = 0;
+
+/************************************************
+ * STARTUP
+ ***********************************************/
+static void xPreloadLock()
+{
+  pthread_mutex_lock(&xPreloadMutex);
+}
+
+static void xPreloadUnlock()
+{
+  pthread_mutex_unlock(&xPreloadMutex);
+}
+
+/* a bootstrap block is preceded by its size, it is never freed */
+static void* xPreloadBootstrapAlloc(size_t size)
+{
+  size_t *addr;
+  size  = (size + __XMALLOC_PRELOAD_ALIGNMENT - 1) &
+            ~((size_t) __XMALLOC_PRELOAD_ALIGNMENT - 1);
+  if (xPreloadBootstrapUsed + __XMALLOC_PRELOAD_ALIGNMENT + size >
+      __XMALLOC_PRELOAD_BOOTSTRAP_SIZE)
+  {
+    errno = ENOMEM;
+    return NULL;
+  }
+  xPreloadBootstrapUsed +=  __XMALLOC_PRELOAD_ALIGNMENT;
+  addr  = (size_t *) (xPreloadBootstrap + xPreloadBootstrapUsed);
+  addr[-1]  = size;
+  xPreloadBootstrapUsed +=  size;
+  return addr;
+}
+
+static inline xBin xPreloadSize2Bin(size_t size)
+{
+  return xPreloadBin[(size + __XMALLOC_PRELOAD_ALIGNMENT - 1) /
+                     __XMALLOC_PRELOAD_ALIGNMENT];
+}
+
+static inline int xPreloadIsBootstrapAddr(const void *addr)
+{
+  return ((const char *) addr >= xPreloadBootstrap &&
+          (const char *) addr < xPreloadBootstrap +
+                                  __XMALLOC_PRELOAD_BOOTSTRAP_SIZE);
+}
+
+static void xPreloadInit()
+{
+  unsigned long i;
+  xBin bin;
+
+  if (xPreloadInitializing)
+    return;
+  xPreloadInitializing  = 1;
+  for (i = 0; i < sizeof(xPreloadBin) / sizeof(xBin); i++)
+  {
+    bin = xSmallSize2Bin(i > 0 ? i * __XMALLOC_PRELOAD_ALIGNMENT :
+                                  __XMALLOC_PRELOAD_ALIGNMENT);
+    // pages start aligned after their header, so do blocks of a size
+    // which is a multiple of the alignment
+    while (0 != ((bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT) &
+                 (__XMALLOC_PRELOAD_ALIGNMENT - 1)))
+      bin++;
+    xPreloadBin[i]  = bin;
+  }
+  // dlsym() may allocate itself, this is served by the bootstrap buffer
+  xSystemRealloc    = dlsym(RTLD_NEXT, "realloc");
+  xSystemFree       = dlsym(RTLD_NEXT, "free");
+  xSystemMemalign   = dlsym(RTLD_NEXT, "memalign");
+  xSystemCalloc     = dlsym(RTLD_NEXT, "calloc");
+  xSystemUsableSize = dlsym(RTLD_NEXT, "malloc_usable_size");
+  xSystemMalloc     = dlsym(RTLD_NEXT, "malloc");
+  if (NULL == xSystemMalloc || NULL == xSystemRealloc ||
+      NULL == xSystemFree || NULL == xSystemMemalign ||
+      NULL == xSystemCalloc || NULL == xSystemUsableSize)
+  {
+    static const char msg[]  =
+      "xmalloc: cannot resolve the malloc functions of the C library\n";
+    if (write(STDERR_FILENO, msg, sizeof(msg) - 1)) {}
+    abort();
+  }
+  // a child must not inherit a locked allocator
+  pthread_atfork(xPreloadLock, xPreloadUnlock, xPreloadUnlock);
+  xPreloadInitializing  = 0;
+}
+
+static void __attribute__ ((constructor)) xPreloadConstructor()
+{
+  if (NULL == xSystemMalloc)
+    xPreloadInit();
+}
+
+/************************************************
+ * MALLOC FAMILY
+ ***********************************************/
+/* the compiler would turn malloc() followed by memset() in calloc() into a
+ * call of calloc(), so the allocation itself is done here */
+static inline void* xPreloadMalloc(size_t size)
+{
+  void *addr;
+  if (NULL == xSystemMalloc)
+  {
+    xPreloadInit();
+    if (xPreloadInitializing)
+      return xPreloadBootstrapAlloc(size);
+  }
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+  {
+    xPreloadLock();
+    addr  = xAllocFromBin(xPreloadSize2Bin(size));
+    xPreloadUnlock();
+    return addr;
+  }
+  return xSystemMalloc(size);
+}
+
+void* malloc(size_t size)
+{
+  return xPreloadMalloc(size);
+}
+
+void free(void *addr)
+{
+  if (NULL == addr || xPreloadIsBootstrapAddr(addr))
+    return;
+  xPreloadLock();
+  if (xIsBinAddr(addr))
+  {
+    xFreeBinAddr(addr);
+    xPreloadUnlock();
+    return;
+  }
+  xPreloadUnlock();
+  xSystemFree(addr);
+}
+
+void* calloc(size_t number, size_t size)
+{
+  void *addr;
+  if (0 != size && number > SIZE_MAX / size)
+  {
+    errno = ENOMEM;
+    return NULL;
+  }
+  size  *=  number;
+  if (size > __XMALLOC_MAX_SMALL_BLOCK_SIZE && NULL != xSystemCalloc)
+    // the C library knows if fresh memory needs to be cleared
+    return xSystemCalloc(1, size);
+  addr  = xPreloadMalloc(size);
+  if (NULL != addr)
+    memset(addr, 0, size);
+  return addr;
+}
+
+void* realloc(void *addr, size_t size)
+{
+  void *newAddr;
+  size_t oldSize;
+
+  if (NULL == addr)
+    return xPreloadMalloc(size);
+  if (0 == size)
+  {
+    free(addr);
+    return NULL;
+  }
+  if (xPreloadIsBootstrapAddr(addr))
+  {
+    oldSize = ((size_t *) addr)[-1];
+  }
+  else
+  {
+    xPreloadLock();
+    if (!xIsBinAddr(addr))
+    {
+      xPreloadUnlock();
+      if (size > __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+        return xSystemRealloc(addr, size);
+      oldSize = xSystemUsableSize(addr);
+    }
+    else
+    {
+      oldSize = xSizeOfBinAddr(addr);
+      xPreloadUnlock();
+      // staying in the same bin
+      if (size <= oldSize && (xPreloadSize2Bin(size)->sizeInWords <<
+                              __XMALLOC_LOG_SIZEOF_ALIGNMENT) == oldSize)
+        return addr;
+    }
+  }
+  newAddr = xPreloadMalloc(size);
+  if (NULL == newAddr)
+    return NULL;
+  memcpy(newAddr, addr, (size < oldSize ? size : oldSize));
+  free(addr);
+  return newAddr;
+}
+
+static void* xPreloadMemalign(size_t alignment, size_t size)
+{
+  void *addr;
+  xBin bin;
+  if (alignment <= __XMALLOC_PRELOAD_ALIGNMENT)
+    return xPreloadMalloc(size);
+  // small blocks up to __XMALLOC_MAX_BIN_ALIGNMENT come from a bin keeping
+  // the alignment, large aligned chunks of xmalloc are not used since free()
+  // hands everything which is no bin address to the C library
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE &&
+      alignment <= __XMALLOC_MAX_BIN_ALIGNMENT && NULL != xSystemMalloc)
+  {
+    // the bin is created on first use
+    xPreloadLock();
+    bin   = xAlignedSize2Bin(size, alignment);
+    addr  = xAllocFromBin(bin);
+    xPreloadUnlock();
+    return addr;
+  }
+  if (NULL == xSystemMalloc)
+  {
+    xPreloadInit();
+    if (xPreloadInitializing)
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+  }
+  return xSystemMemalign(alignment, size);
+}
+
+int posix_memalign(void **addr, size_t alignment, size_t size)
+{
+  void *newAddr;
+  if (0 != (alignment & (alignment - 1)) || 0 == alignment ||
+      0 != alignment % sizeof(void*))
+    return EINVAL;
+  newAddr = xPreloadMemalign(alignment, size);
+  if (NULL == newAddr)
+    return ENOMEM;
+  *addr = newAddr;
+  return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+  if (0 != (alignment & (alignment - 1)) || 0 == alignment)
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+  return xPreloadMemalign(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+  // as the C library an alignment which is no power of 2 is rounded up
+  while (0 != (alignment & (alignment - 1)))
+    alignment = (alignment | (alignment - 1)) + 1;
+  return xPreloadMemalign(alignment, size);
+}
+
+void* valloc(size_t size)
+{
+  return xPreloadMemalign(__XMALLOC_SIZEOF_SYSTEM_PAGE, size);
+}
+
+size_t malloc_usable_size(void *addr)
+{
+  size_t size;
+  if (NULL == addr)
+    return 0;
+  if (xPreloadIsBootstrapAddr(addr))
+    return ((size_t *) addr)[-1];
+  xPreloadLock();
+  if (xIsBinAddr(addr))
+  {
+    size  = xSizeOfBinAddr(addr);
+    xPreloadUnlock();
+    return size;
+  }
+  xPreloadUnlock();
+  return xSystemUsableSize(addr);
+}
@@ -0,0 +1,50 @@
+/**
+ * \file   probes.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Static tracepoints for xmalloc. If xmalloc is configured with
+ *         --enable-sdt, SystemTap-style SDT probes are placed on the slow
+ *         paths of the allocator. Those can be attached to by perf, bpftrace
+ *         or SystemTap without rebuilding, e.g.
+ *           perf buildid-cache --add ./prog
+ *           perf probe sdt_xmalloc:region__alloc
+ *           bpftrace -e 'usdt:./prog:xmalloc:page__alloc { ... }'
+ *         A probe nobody is attached to is a single nop instruction.
+ *
+ *         Available probes ( provider xmalloc ):
+ *         region__alloc      (addr, numberPages)
+ *         region__free       (addr, numberPages)
+ *         page__alloc        (bin, blockSize, numberBlocks, page)
+ *         page__fault        (bin, blockSize, page, numberPagesReleased)
+ *         page__index__fault (startIndex, endIndex)
+ *         specbin__get       (size)
+ *         specbin__new       (bin, size, numberBlocks)
+ *         large__alloc       (addr, size)
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_PROBES_H
+#define XMALLOC_PROBES_H
+
+#include "xmalloc-config.h"
+
+#ifdef __XMALLOC_SDT
+#include <sys/sdt.h>
+
+#define __XMALLOC_PROBE1(name, a1)                                  \
+  DTRACE_PROBE1(xmalloc, name, a1)
+#define __XMALLOC_PROBE2(name, a1, a2)                              \
+  DTRACE_PROBE2(xmalloc, name, a1, a2)
+#define __XMALLOC_PROBE3(name, a1, a2, a3)                          \
+  DTRACE_PROBE3(xmalloc, name, a1, a2, a3)
+#define __XMALLOC_PROBE4(name, a1, a2, a3, a4)                      \
+  DTRACE_PROBE4(xmalloc, name, a1, a2, a3, a4)
+#else
+#define __XMALLOC_PROBE1(name, a1)              ((void) 0)
+#define __XMALLOC_PROBE2(name, a1, a2)          ((void) 0)
+#define __XMALLOC_PROBE3(name, a1, a2, a3)      ((void) 0)
+#define __XMALLOC_PROBE4(name, a1, a2, a3, a4)  ((void) 0)
+#endif
+
+#endif
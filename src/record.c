@@ -0,0 +1,577 @@
+/**
+ * \file   record.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Source file for recording and reading allocation streams.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "src/xmalloc.h"
+
+/************************************************
+ * VARINT ENCODING
+ ***********************************************/
+static inline unsigned long long xRecordZigZag(long long value)
+{
+  return ((unsigned long long) value << 1) ^ (unsigned long long) (value >> 63);
+}
+
+static inline long long xRecordUnZigZag(unsigned long long value)
+{
+  return (long long) (value >> 1) ^ -(long long) (value & 1);
+}
+
+static inline unsigned char* xRecordPutVarint(unsigned char *data,
+    unsigned long long value)
+{
+  while (value >= 0x80)
+  {
+    *data++ =   (unsigned char) (value | 0x80);
+    value   >>= 7;
+  }
+  *data++ = (unsigned char) value;
+  return data;
+}
+
+static inline int xRecordGetVarint(xRecordReader *reader,
+    unsigned long long *value)
+{
+  unsigned long long result = 0;
+  unsigned int shift        = 0;
+  unsigned char byte;
+  do
+  {
+    if (reader->position >= reader->length || shift > 63)
+      return -1;
+    byte    =   reader->data[reader->position++];
+    result  |=  (unsigned long long) (byte & 0x7f) << shift;
+    shift   +=  7;
+  } while (byte & 0x80);
+  *value  = result;
+  return 0;
+}
+
+#ifdef __XMALLOC_RECORD
+/************************************************
+ * RECORDING
+ ***********************************************/
+volatile int xRecordActive  = 0;
+__thread int xRecordDepth __XMALLOC_TLS_MODEL = 0;
+
+static __thread xRecordBuffer xRecordLocalBuffer __XMALLOC_TLS_MODEL = NULL;
+static xRecordBuffer volatile xRecordBuffers      = NULL;
+static volatile unsigned int xRecordNumberThreads = 0;
+static volatile int xRecordLock                   = 0;
+static volatile int xRecordFileLock               = 0;
+static FILE *xRecordFile                          = NULL;
+static long xRecordBytes                          = 0;
+static unsigned long long xRecordNextId           = 1;
+
+/* xRecordLock guards the id map and the encoding of records into the
+ * buffers, xRecordFileLock the record file and the writing of buffers to it,
+ * so threads go on recording while one writes its buffer */
+static inline void xRecordAcquire(volatile int *lock)
+{
+  while (__sync_lock_test_and_set(lock, 1))
+    while (*lock)
+      ;
+}
+
+static inline void xRecordRelease(volatile int *lock)
+{
+  __sync_lock_release(lock);
+}
+
+/************************************************
+ * ADDRESS -> ID MAP
+ * open addressing, the key 0 marks an empty slot, 1 a deleted one; both are
+ * no valid addresses of xmalloc
+ ***********************************************/
+struct xRecordSlotStruct {
+  unsigned long       key;
+  unsigned long long  id;
+};
+
+static struct xRecordSlotStruct *xRecordMap = NULL;
+static unsigned long xRecordMapSize         = 0;
+static unsigned long xRecordMapUsed         = 0;
+static unsigned long xRecordMapLive         = 0;
+
+#define __XMALLOC_RECORD_EMPTY    0UL
+#define __XMALLOC_RECORD_DELETED  1UL
+
+static inline unsigned long xRecordHash(unsigned long key)
+{
+  return (unsigned long) (((unsigned long long) (key >> 3) *
+            0x9E3779B97F4A7C15ULL) >> 17) & (xRecordMapSize - 1);
+}
+
+static void xRecordMapResize(unsigned long size)
+{
+  struct xRecordSlotStruct *oldMap  = xRecordMap;
+  unsigned long oldSize             = xRecordMapSize, i, j;
+
+  xRecordMap      = xAllocFromSystem(size * sizeof(struct xRecordSlotStruct));
+  memset(xRecordMap, 0, size * sizeof(struct xRecordSlotStruct));
+  xRecordMapSize  = size;
+  xRecordMapUsed  = 0;
+  for (i = 0; i < oldSize; i++)
+  {
+    if (oldMap[i].key <= __XMALLOC_RECORD_DELETED)
+      continue;
+    j = xRecordHash(oldMap[i].key);
+    while (__XMALLOC_RECORD_EMPTY != xRecordMap[j].key)
+      j = (j + 1) & (xRecordMapSize - 1);
+    xRecordMap[j] = oldMap[i];
+    xRecordMapUsed++;
+  }
+  if (NULL != oldMap)
+    xFreeSizeToSystem(oldMap, oldSize * sizeof(struct xRecordSlotStruct));
+}
+
+/* removes addr and returns its id, 0 if addr is unknown */
+static unsigned long long xRecordMapRemove(const void *addr)
+{
+  unsigned long key = (unsigned long) addr;
+  unsigned long i   = xRecordHash(key);
+  unsigned long long id;
+
+  while (__XMALLOC_RECORD_EMPTY != xRecordMap[i].key)
+  {
+    if (key == xRecordMap[i].key)
+    {
+      id                  = xRecordMap[i].id;
+      xRecordMap[i].key   = __XMALLOC_RECORD_DELETED;
+      xRecordMapLive--;
+      return id;
+    }
+    i = (i + 1) & (xRecordMapSize - 1);
+  }
+  return 0;
+}
+
+static unsigned long long xRecordMapFind(const void *addr)
+{
+  unsigned long key = (unsigned long) addr;
+  unsigned long i   = xRecordHash(key);
+
+  while (__XMALLOC_RECORD_EMPTY != xRecordMap[i].key)
+  {
+    if (key == xRecordMap[i].key)
+      return xRecordMap[i].id;
+    i = (i + 1) & (xRecordMapSize - 1);
+  }
+  return 0;
+}
+
+/* assigns a new id to addr */
+static unsigned long long xRecordMapInsert(const void *addr)
+{
+  unsigned long key = (unsigned long) addr;
+  unsigned long i;
+
+  xRecordMapRemove(addr);
+  // deleted slots are only reclaimed on resizing
+  if (4 * (xRecordMapUsed + 1) > 3 * xRecordMapSize)
+    xRecordMapResize(4 * (xRecordMapLive + 1) > xRecordMapSize ?
+        2 * xRecordMapSize : xRecordMapSize);
+  i = xRecordHash(key);
+  while (xRecordMap[i].key > __XMALLOC_RECORD_DELETED)
+    i = (i + 1) & (xRecordMapSize - 1);
+  if (__XMALLOC_RECORD_EMPTY == xRecordMap[i].key)
+    xRecordMapUsed++;
+  xRecordMapLive++;
+  xRecordMap[i].key = key;
+  xRecordMap[i].id  = xRecordNextId++;
+  return xRecordMap[i].id;
+}
+
+/************************************************
+ * PER-THREAD BUFFERS
+ ***********************************************/
+static inline void xRecordResetBuffer(xRecordBuffer buffer)
+{
+  buffer->length    = 0;
+  buffer->tsc       = xReadTsc();
+  buffer->lastTsc   = buffer->tsc;
+  buffer->lastId    = 0;
+  buffer->lastSize  = 0;
+}
+
+/* writes the records of buffer to the file and empties it, a buffer written
+ * meanwhile by xRecordStop() is empty */
+static void xRecordFlushBuffer(xRecordBuffer buffer)
+{
+  xRecordChunk chunk;
+  xRecordAcquire(&xRecordFileLock);
+  if (0 != buffer->length && NULL != xRecordFile)
+  {
+    chunk.thread  = buffer->thread;
+    chunk.length  = buffer->length;
+    chunk.tsc     = buffer->tsc;
+    fwrite(&chunk, sizeof(chunk), 1, xRecordFile);
+    fwrite(buffer->data, 1, buffer->length, xRecordFile);
+    xRecordBytes  +=  sizeof(chunk) + buffer->length;
+  }
+  xRecordResetBuffer(buffer);
+  xRecordRelease(&xRecordFileLock);
+}
+
+static xRecordBuffer xRecordRegisterThread()
+{
+  xRecordBuffer buffer  = xAllocFromSystem(sizeof(xRecordBufferType));
+  xRecordBuffer root;
+
+  buffer->thread  = __sync_fetch_and_add(&xRecordNumberThreads, 1);
+  xRecordResetBuffer(buffer);
+  do
+  {
+    root          = xRecordBuffers;
+    buffer->next  = root;
+  } while (!__sync_bool_compare_and_swap(&xRecordBuffers, root, buffer));
+
+  xRecordLocalBuffer  = buffer;
+  return buffer;
+}
+
+/* returns the buffer of the calling thread, it always has enough space for
+ * one record, see xRecordCheckBuffer() */
+static inline xRecordBuffer xRecordGetBuffer()
+{
+  xRecordBuffer buffer  = xRecordLocalBuffer;
+  if (NULL == buffer)
+    buffer  = xRecordRegisterThread();
+  return buffer;
+}
+
+/* called without xRecordLock after each record, writes the buffer once it
+ * has no space for the next one */
+static inline void xRecordCheckBuffer(xRecordBuffer buffer)
+{
+  if (buffer->length + __XMALLOC_RECORD_MAX_ENTRY_SIZE >
+      __XMALLOC_RECORD_BUFFER_SIZE)
+    xRecordFlushBuffer(buffer);
+}
+
+static inline unsigned char* xRecordPutHead(xRecordBuffer buffer,
+    unsigned int op)
+{
+  unsigned char *data = buffer->data + buffer->length;
+  unsigned long long tsc  = xReadTsc();
+  *data++         = (unsigned char) op;
+  data            = xRecordPutVarint(data, tsc - buffer->lastTsc);
+  buffer->lastTsc = tsc;
+  return data;
+}
+
+static inline unsigned char* xRecordPutDelta(unsigned char *data,
+    unsigned long long value, unsigned long long base)
+{
+  return xRecordPutVarint(data, xRecordZigZag((long long) (value - base)));
+}
+
+void xRecordMalloc(void *addr, size_t size)
+{
+  xRecordBuffer buffer;
+  unsigned char *data;
+  unsigned long long id;
+
+  if (0 != xRecordDepth)
+    return;
+  buffer  = xRecordGetBuffer();
+  xRecordAcquire(&xRecordLock);
+  if (xRecordActive)
+  {
+    id                = xRecordMapInsert(addr);
+    data              = xRecordPutHead(buffer, xRecord_Malloc);
+    data              = xRecordPutDelta(data, id, buffer->lastId);
+    data              = xRecordPutDelta(data, size, buffer->lastSize);
+    buffer->lastId    = id;
+    buffer->lastSize  = size;
+    buffer->length    = data - buffer->data;
+  }
+  xRecordRelease(&xRecordLock);
+  xRecordCheckBuffer(buffer);
+}
+
+void xRecordFree(void *addr)
+{
+  xRecordBuffer buffer;
+  unsigned char *data;
+  unsigned long long id;
+
+  if (0 != xRecordDepth)
+    return;
+  buffer  = xRecordGetBuffer();
+  xRecordAcquire(&xRecordLock);
+  if (xRecordActive)
+  {
+    id              = xRecordMapRemove(addr);
+    data            = xRecordPutHead(buffer, xRecord_Free);
+    data            = xRecordPutDelta(data, id, buffer->lastId);
+    buffer->lastId  = id;
+    buffer->length  = data - buffer->data;
+  }
+  xRecordRelease(&xRecordLock);
+  xRecordCheckBuffer(buffer);
+}
+
+void xRecordRealloc(void *oldAddr, size_t oldSize, void *addr, size_t size)
+{
+  xRecordBuffer buffer;
+  unsigned char *data;
+  unsigned long long oldId, id;
+
+  if (0 != xRecordDepth)
+    return;
+  buffer  = xRecordGetBuffer();
+  xRecordAcquire(&xRecordLock);
+  if (xRecordActive)
+  {
+    oldId             = xRecordMapRemove(oldAddr);
+    id                = xRecordMapInsert(addr);
+    data              = xRecordPutHead(buffer, xRecord_Realloc);
+    data              = xRecordPutDelta(data, oldId, buffer->lastId);
+    data              = xRecordPutDelta(data, id, oldId);
+    data              = xRecordPutDelta(data, oldSize, buffer->lastSize);
+    data              = xRecordPutDelta(data, size, oldSize);
+    buffer->lastId    = id;
+    buffer->lastSize  = size;
+    buffer->length    = data - buffer->data;
+  }
+  xRecordRelease(&xRecordLock);
+  xRecordCheckBuffer(buffer);
+}
+
+void xRecordGetSpecBin(xBin bin, size_t size)
+{
+  xRecordBuffer buffer;
+  unsigned char *data;
+  unsigned long long id = 0;
+
+  if (0 != xRecordDepth)
+    return;
+  buffer  = xRecordGetBuffer();
+  xRecordAcquire(&xRecordLock);
+  if (xRecordActive)
+  {
+    if (!xIsStaticBin(bin))
+      id              = xRecordMapInsert(bin);
+    data              = xRecordPutHead(buffer, xRecord_GetSpecBin);
+    data              = xRecordPutDelta(data, id, buffer->lastId);
+    data              = xRecordPutDelta(data, size, buffer->lastSize);
+    buffer->lastId    = id;
+    buffer->lastSize  = size;
+    buffer->length    = data - buffer->data;
+  }
+  xRecordRelease(&xRecordLock);
+  xRecordCheckBuffer(buffer);
+}
+
+void xRecordAllocBin(void *addr, xBin bin)
+{
+  xRecordBuffer buffer;
+  unsigned char *data;
+  unsigned long long id, binId = 0;
+  unsigned long long size = bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+
+  if (0 != xRecordDepth)
+    return;
+  buffer  = xRecordGetBuffer();
+  xRecordAcquire(&xRecordLock);
+  if (xRecordActive)
+  {
+    if (!xIsStaticBin(bin))
+      binId           = xRecordMapFind(bin);
+    id                = xRecordMapInsert(addr);
+    data              = xRecordPutHead(buffer, xRecord_AllocBin);
+    data              = xRecordPutDelta(data, id, buffer->lastId);
+    data              = xRecordPutDelta(data, binId, id);
+    data              = xRecordPutDelta(data, size, buffer->lastSize);
+    buffer->lastId    = id;
+    buffer->lastSize  = size;
+    buffer->length    = data - buffer->data;
+  }
+  xRecordRelease(&xRecordLock);
+  xRecordCheckBuffer(buffer);
+}
+
+int xRecordStart(const char *fileName)
+{
+  xRecordHeader header;
+  xRecordBuffer buffer;
+  int ret = -1;
+
+  xRecordAcquire(&xRecordLock);
+  xRecordAcquire(&xRecordFileLock);
+  if (NULL == xRecordFile)
+    xRecordFile = fopen(fileName, "wb");
+  else
+    goto Done;
+  if (NULL == xRecordFile)
+    goto Done;
+  memcpy(header.magic, __XMALLOC_RECORD_MAGIC, sizeof(header.magic));
+  header.ticksPerNs = xTscTicksPerNanosecond();
+  fwrite(&header, sizeof(header), 1, xRecordFile);
+  xRecordBytes  = sizeof(header);
+
+  if (NULL != xRecordMap)
+    xFreeSizeToSystem(xRecordMap,
+        xRecordMapSize * sizeof(struct xRecordSlotStruct));
+  xRecordMap      = NULL;
+  xRecordMapSize  = 0;
+  xRecordMapLive  = 0;
+  xRecordMapResize(4096);
+  xRecordNextId   = 1;
+  for (buffer = xRecordBuffers; NULL != buffer; buffer = buffer->next)
+    xRecordResetBuffer(buffer);
+  xRecordActive = 1;
+  ret           = 0;
+
+  Done:
+  xRecordRelease(&xRecordFileLock);
+  xRecordRelease(&xRecordLock);
+  return ret;
+}
+
+long xRecordStop()
+{
+  xRecordBuffer buffer;
+  long bytes  = -1;
+
+  xRecordAcquire(&xRecordLock);
+  xRecordActive = 0;
+  xRecordRelease(&xRecordLock);
+  // no records are added anymore, buffers being written by their threads
+  // are empty afterwards
+  for (buffer = xRecordBuffers; NULL != buffer; buffer = buffer->next)
+    xRecordFlushBuffer(buffer);
+  xRecordAcquire(&xRecordFileLock);
+  if (NULL != xRecordFile)
+  {
+    bytes = (0 == fclose(xRecordFile) ? xRecordBytes : -1);
+    xRecordFile = NULL;
+  }
+  xRecordRelease(&xRecordFileLock);
+  return bytes;
+}
+#else
+int xRecordStart(const char *fileName)
+{
+  return -1;
+}
+
+long xRecordStop()
+{
+  return -1;
+}
+#endif
+
+/************************************************
+ * READING
+ ***********************************************/
+int xRecordOpen(xRecordReader *reader, const char *fileName)
+{
+  xRecordHeader header;
+
+  memset(reader, 0, sizeof(xRecordReader));
+  reader->file  = fopen(fileName, "rb");
+  if (NULL == reader->file)
+    return -1;
+  if (1 != fread(&header, sizeof(header), 1, reader->file) ||
+      0 != memcmp(header.magic, __XMALLOC_RECORD_MAGIC, sizeof(header.magic)))
+  {
+    fclose(reader->file);
+    reader->file  = NULL;
+    return -1;
+  }
+  reader->ticksPerNs  = header.ticksPerNs;
+  reader->data        = xAllocFromSystem(__XMALLOC_RECORD_BUFFER_SIZE);
+  return 0;
+}
+
+static inline int xRecordGetDelta(xRecordReader *reader,
+    unsigned long long *value, unsigned long long base)
+{
+  unsigned long long delta;
+  if (0 != xRecordGetVarint(reader, &delta))
+    return -1;
+  *value  = base + (unsigned long long) xRecordUnZigZag(delta);
+  return 0;
+}
+
+int xRecordRead(xRecordReader *reader, xRecordEntry *entry)
+{
+  unsigned long long delta;
+  int error;
+
+  if (NULL == reader->file)
+    return -1;
+  if (reader->position >= reader->length)
+  {
+    xRecordChunk chunk;
+    if (1 != fread(&chunk, sizeof(chunk), 1, reader->file))
+      return (feof(reader->file) ? 0 : -1);
+    if (0 == chunk.length || chunk.length > __XMALLOC_RECORD_BUFFER_SIZE ||
+        chunk.length != fread(reader->data, 1, chunk.length, reader->file))
+      return -1;
+    reader->thread    = chunk.thread;
+    reader->length    = chunk.length;
+    reader->position  = 0;
+    reader->lastTsc   = chunk.tsc;
+    reader->lastId    = 0;
+    reader->lastSize  = 0;
+  }
+
+  memset(entry, 0, sizeof(xRecordEntry));
+  entry->op     = reader->data[reader->position++];
+  entry->thread = reader->thread;
+  if (0 != xRecordGetVarint(reader, &delta))
+    return -1;
+  entry->tsc  = reader->lastTsc + delta;
+  switch (entry->op)
+  {
+    case xRecord_Malloc:
+    case xRecord_GetSpecBin:
+      error = xRecordGetDelta(reader, &entry->id, reader->lastId) ||
+              xRecordGetDelta(reader, &entry->size, reader->lastSize);
+      break;
+    case xRecord_Free:
+      error = xRecordGetDelta(reader, &entry->id, reader->lastId);
+      entry->size = reader->lastSize;
+      break;
+    case xRecord_Realloc:
+      error = xRecordGetDelta(reader, &entry->oldId, reader->lastId) ||
+              xRecordGetDelta(reader, &entry->id, entry->oldId) ||
+              xRecordGetDelta(reader, &entry->oldSize, reader->lastSize) ||
+              xRecordGetDelta(reader, &entry->size, entry->oldSize);
+      break;
+    case xRecord_AllocBin:
+      error = xRecordGetDelta(reader, &entry->id, reader->lastId) ||
+              xRecordGetDelta(reader, &entry->oldId, entry->id) ||
+              xRecordGetDelta(reader, &entry->size, reader->lastSize);
+      break;
+    default:
+      return -1;
+  }
+  if (error)
+    return -1;
+  reader->lastTsc   = entry->tsc;
+  reader->lastId    = entry->id;
+  reader->lastSize  = entry->size;
+  return 1;
+}
+
+void xRecordClose(xRecordReader *reader)
+{
+  if (NULL != reader->file)
+    fclose(reader->file);
+  if (NULL != reader->data)
+    xFreeSizeToSystem(reader->data, __XMALLOC_RECORD_BUFFER_SIZE);
+  reader->file  = NULL;
+  reader->data  = NULL;
+}
@@ -0,0 +1,246 @@
+/**
+ * \file   record.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Allocation stream recorder for xmalloc. If xmalloc is configured
+ *         with --enable-record, every call of xMalloc(), xMalloc0(), xFree(),
+ *         xFreeSize(), xReallocSize(), xRealloc0Size(), xGetSpecBin() and
+ *         xAllocBin() between xRecordStart() and xRecordStop() is logged to a
+ *         compact binary file which can be replayed offline.
+ *
+ *         File layout: An \c xRecordHeader followed by chunks. Each chunk is
+ *         an \c xRecordChunk followed by \c length bytes of records of one
+ *         thread. A record is its \c xRecordOp_e byte, the time stamp delta
+ *         and the operands, all of them as LEB128 varints. Pointer ids and
+ *         sizes are zigzag-encoded deltas to the previous record of the same
+ *         chunk:
+ *           Malloc      id, size
+ *           Free        id
+ *           Realloc     oldId, id, oldSize, size
+ *           GetSpecBin  binId, size
+ *           AllocBin    id, binId, size of the blocks of the bin
+ *         Ids are handed out at allocation time starting with 1, id 0
+ *         denotes an address allocated before recording was started resp. a
+ *         static bin.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_RECORD_H
+#define XMALLOC_RECORD_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "xmalloc-config.h"
+#include "data.h"
+#include "tsc.h"
+
+/**
+ * \brief Size in bytes of the per-thread record buffer. A full buffer is
+ * written as one chunk.
+ */
+#ifndef __XMALLOC_RECORD_BUFFER_SIZE
+#define __XMALLOC_RECORD_BUFFER_SIZE 65536
+#endif
+
+/**
+ * \brief Upper bound for the encoded size of one record.
+ */
+#define __XMALLOC_RECORD_MAX_ENTRY_SIZE 64
+
+/**
+ * \brief Magic string at the beginning of a record file.
+ */
+#define __XMALLOC_RECORD_MAGIC "XMRECRD1"
+
+enum xRecordOp_e {
+  xRecord_Malloc = 0,
+  xRecord_Free,
+  xRecord_Realloc,
+  xRecord_GetSpecBin,
+  xRecord_AllocBin,
+  xRecord_MaxOp
+};
+
+struct xRecordBufferStruct;
+typedef struct xRecordBufferStruct  xRecordBufferType;
+typedef xRecordBufferType*          xRecordBuffer;
+
+/**
+ * \struct xRecordHeaderStruct
+ *
+ * \brief Header of a record file.
+ */
+struct xRecordHeaderStruct {
+  char    magic[8];     /**< __XMALLOC_RECORD_MAGIC */
+  double  ticksPerNs;   /**< time stamp ticks per ns */
+};
+
+typedef struct xRecordHeaderStruct xRecordHeader;
+
+/**
+ * \struct xRecordChunkStruct
+ *
+ * \brief Header of a chunk of records of one thread. The deltas of the
+ * first record of a chunk are taken w.r.t. \c tsc , id 0 and size 0.
+ */
+struct xRecordChunkStruct {
+  unsigned int        thread; /**< number of the recording thread */
+  unsigned int        length; /**< number of bytes of records */
+  unsigned long long  tsc;    /**< time stamp counter at chunk start */
+};
+
+typedef struct xRecordChunkStruct xRecordChunk;
+
+/**
+ * \struct xRecordBufferStruct
+ *
+ * \brief Per-thread buffer of encoded records. Only the owning thread
+ * writes to it.
+ */
+struct xRecordBufferStruct {
+  xRecordBuffer       next;     /**< next registered buffer */
+  unsigned int        thread;   /**< number of the owning thread */
+  unsigned int        length;   /**< number of bytes used in data */
+  unsigned long long  tsc;      /**< time stamp counter at chunk start */
+  unsigned long long  lastTsc;  /**< time stamp of the last record */
+  unsigned long long  lastId;   /**< id of the last record */
+  unsigned long long  lastSize; /**< size of the last record */
+  unsigned char data[__XMALLOC_RECORD_BUFFER_SIZE]; /**< encoded records */
+};
+
+/**
+ * \struct xRecordEntryStruct
+ *
+ * \brief One decoded record.
+ */
+struct xRecordEntryStruct {
+  unsigned int        op;       /**< \c xRecordOp_e */
+  unsigned int        thread;   /**< number of the recording thread */
+  unsigned long long  tsc;      /**< time stamp counter */
+  unsigned long long  id;       /**< id of the (new) address resp. bin */
+  unsigned long long  oldId;    /**< Realloc: id of the old address,
+                                     AllocBin: id of the bin */
+  unsigned long long  size;     /**< (new) size */
+  unsigned long long  oldSize;  /**< Realloc: old size */
+};
+
+typedef struct xRecordEntryStruct xRecordEntry;
+
+/**
+ * \struct xRecordReaderStruct
+ *
+ * \brief State of reading a record file chunk by chunk.
+ */
+struct xRecordReaderStruct {
+  FILE                *file;        /**< record file */
+  double              ticksPerNs;   /**< from the file header */
+  unsigned int        thread;       /**< thread of the current chunk */
+  unsigned int        length;       /**< length of the current chunk */
+  unsigned int        position;     /**< read position in the chunk */
+  unsigned long long  lastTsc;      /**< decoding state */
+  unsigned long long  lastId;       /**< decoding state */
+  unsigned long long  lastSize;     /**< decoding state */
+  unsigned char       *data;        /**< current chunk */
+};
+
+typedef struct xRecordReaderStruct xRecordReader;
+
+/**
+ * \fn int xRecordStart(const char *fileName)
+ *
+ * \brief Starts recording all allocations to \c fileName .
+ *
+ * \param fileName name of the record file, it is overwritten
+ *
+ * \return 0 on success, -1 if the file could not be opened, recording is
+ * already running or xmalloc is not configured with --enable-record
+ *
+ */
+int xRecordStart(const char *fileName);
+
+/**
+ * \fn long xRecordStop()
+ *
+ * \brief Stops recording, writes the buffers of all threads and closes the
+ * record file. Other threads must not allocate meanwhile.
+ *
+ * \return number of bytes written, -1 if recording was not running
+ *
+ */
+long xRecordStop();
+
+/**
+ * \fn int xRecordOpen(xRecordReader *reader, const char *fileName)
+ *
+ * \brief Opens the record file \c fileName for reading. This works
+ * independent of --enable-record.
+ *
+ * \param reader \c xRecordReader to be initialized
+ *
+ * \param fileName name of the record file
+ *
+ * \return 0 on success, -1 if \c fileName is no record file
+ *
+ */
+int xRecordOpen(xRecordReader *reader, const char *fileName);
+
+/**
+ * \fn int xRecordRead(xRecordReader *reader, xRecordEntry *entry)
+ *
+ * \brief Reads the next record. Records are in file order, i.e. ordered by
+ * time for each thread, but chunks of different threads are not merged.
+ *
+ * \param reader \c xRecordReader
+ *
+ * \param entry \c xRecordEntry the record is stored in
+ *
+ * \return 1 if a record was read, 0 at the end of the file, -1 if the file
+ * is corrupt
+ *
+ */
+int xRecordRead(xRecordReader *reader, xRecordEntry *entry);
+
+/**
+ * \fn void xRecordClose(xRecordReader *reader)
+ *
+ * \brief Closes the record file of \c reader .
+ *
+ * \param reader \c xRecordReader
+ *
+ */
+void xRecordClose(xRecordReader *reader);
+
+#ifdef __XMALLOC_RECORD
+extern volatile int xRecordActive;
+extern __thread int xRecordDepth __XMALLOC_TLS_MODEL;
+
+void xRecordMalloc(void *addr, size_t size);
+void xRecordFree(void *addr);
+void xRecordRealloc(void *oldAddr, size_t oldSize, void *addr, size_t size);
+void xRecordGetSpecBin(xBin bin, size_t size);
+void xRecordAllocBin(void *addr, xBin bin);
+
+/* calls inside of recorded functions are not recorded themselves */
+#define __XMALLOC_RECORD_SUSPEND()  (xRecordDepth++)
+#define __XMALLOC_RECORD_RESUME()   (xRecordDepth--)
+#define __XMALLOC_RECORD_CALL(call)                                   \
+  do { if (xRecordActive) call; } while (0)
+#else
+#define __XMALLOC_RECORD_SUSPEND()  ((void) 0)
+#define __XMALLOC_RECORD_RESUME()   ((void) 0)
+#define __XMALLOC_RECORD_CALL(call) ((void) 0)
+#endif
+
+#define __XMALLOC_RECORD_MALLOC(addr, size)                           \
+  __XMALLOC_RECORD_CALL(xRecordMalloc((addr), (size)))
+#define __XMALLOC_RECORD_FREE(addr)                                   \
+  __XMALLOC_RECORD_CALL(xRecordFree((addr)))
+#define __XMALLOC_RECORD_REALLOC(oldAddr, oldSize, addr, size)        \
+  __XMALLOC_RECORD_CALL(xRecordRealloc((oldAddr), (oldSize), (addr), (size)))
+#define __XMALLOC_RECORD_GET_SPEC_BIN(bin, size)                      \
+  __XMALLOC_RECORD_CALL(xRecordGetSpecBin((bin), (size)))
+#define __XMALLOC_RECORD_ALLOC_BIN(addr, bin)                         \
+  __XMALLOC_RECORD_CALL(xRecordAllocBin((addr), (bin)))
+
+#endif
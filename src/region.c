@@ -20,6 +20,7 @@ xRegion xAllocNewRegion(int minNumberPages)
   void *addr;
   int numberPages = __XMALLOC_MAX(minNumberPages, 
                       __XMALLOC_MIN_NUMBER_PAGES_PER_REGION);
+  __XMALLOC_LATENCY_START(start);
   
   addr  = xVallocFromSystem(numberPages * __XMALLOC_SIZEOF_SYSTEM_PAGE);
   if (NULL == addr)
@@ -28,6 +29,9 @@ xRegion xAllocNewRegion(int minNumberPages)
     addr  = xVallocFromSystem(numberPages * __XMALLOC_SIZEOF_SYSTEM_PAGE);
   }
 
+  __XMALLOC_TRACE_EVENT(xTrace_RegionMap, addr, numberPages);
+  __XMALLOC_PROBE2(region__alloc, addr, numberPages);
+
   // register and initialize the region
   xRegisterPagesInRegion(addr, numberPages);
   region->current           = NULL;
@@ -38,6 +42,7 @@ xRegion xAllocNewRegion(int minNumberPages)
   region->numberInitPages   = numberPages;
   region->numberUsedPages   = 0;
   region->totalNumberPages  = numberPages;
+  xNumberEmptyRegions++;
 
 #ifdef __XMALLOC_DEBUG
   info.availablePages +=  numberPages;
@@ -46,6 +51,7 @@ xRegion xAllocNewRegion(int minNumberPages)
     info.maxRegionsAlloc  = info.currentRegionsAlloc;
 #endif
 
+  __XMALLOC_LATENCY_STOP(xLatency_NewRegion, start);
   return region;
 }
 
@@ -98,6 +104,12 @@ void xFreePagesFromRegion(xPage page, int quantity)
   xRegion region          =   page->region;
   region->numberUsedPages -=  quantity;
   if (0 == region->numberUsedPages)
+    xNumberEmptyRegions++;
+  // up to __XMALLOC_MAX_EMPTY_REGIONS empty regions stay mapped, otherwise
+  // allocating and freeing a batch of pages maps and unmaps its regions each
+  // time
+  if (0 == region->numberUsedPages &&
+      xNumberEmptyRegions > __XMALLOC_MAX_EMPTY_REGIONS)
   {
     if (xBaseRegion == region)
     {
@@ -20,6 +20,17 @@
 #include "bin.h"
 #include "align.h"
 #include "system.h"
+#include "trace.h"
+#include "probes.h"
+#include "histogram.h"
+
+/**
+ * \brief Maximal number of regions without used pages which stay mapped.
+ * Further regions are unmapped as soon as their last page is freed.
+ */
+#ifndef __XMALLOC_MAX_EMPTY_REGIONS
+#define __XMALLOC_MAX_EMPTY_REGIONS   4
+#endif
 
 /**
  * \fn static inline int xIsRegionEmpty(xRegion region)
@@ -127,10 +138,14 @@ xPage xGetConsecutivePagesFromRegion(xRegion region, int numberNeeded);
  */
 static inline void xFreeRegion(xRegion region)
 {
+  xNumberEmptyRegions--;
 #ifndef __XMALLOC_NDEBUG
   info.availablePages -=  region->totalNumberPages;
   info.currentRegionsAlloc--;
 #endif
+  __XMALLOC_TRACE_EVENT(xTrace_RegionUnmap, region->addr,
+      region->totalNumberPages);
+  __XMALLOC_PROBE2(region__free, region->addr, region->totalNumberPages);
   xUnregisterPagesFromRegion(region->addr, region->totalNumberPages);
   __XMALLOC_VFREE(region->addr, region->totalNumberPages * __XMALLOC_SIZEOF_SYSTEM_PAGE);
   xFreeSizeToSystem(region, sizeof(xRegionType));
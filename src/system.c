@@ -7,8 +7,12 @@
  *         Public License version 3. See COPYING for more information.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for mremap()
+#endif
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include "src/page.h" // for xIsAddrPageAligned
@@ -17,11 +21,11 @@
 
 void* xAllocFromSystem(size_t size)
 {
-  void *addr  = malloc(size);
+  void *addr  = __XMALLOC_SYSTEM_MALLOC(size);
   if (NULL == addr)
   {
     // try it once more
-    addr  = malloc(size);
+    addr  = __XMALLOC_SYSTEM_MALLOC(size);
     if (NULL == addr)
     {
       printf("out of memory in malloc(%d)\n",errno);
@@ -44,12 +48,42 @@ void* xAllocFromSystem(size_t size)
   return addr; // possibly addr == NULL
 }
 
+void* xAlloc0FromSystem(size_t size)
+{
+  // the system allocator knows if its memory is fresh and zero already
+  void *addr  = __XMALLOC_SYSTEM_CALLOC(1, size);
+  if (NULL == addr)
+  {
+    // try it once more
+    addr  = __XMALLOC_SYSTEM_CALLOC(1, size);
+    if (NULL == addr)
+    {
+      printf("out of memory in calloc(%d)\n",errno);
+      exit(1);
+    }
+  }
+
+#ifndef __XMALLOC_NDEBUG
+  // track some statistics if in debugging mode
+  info.currentBytesFromMalloc +=  size;
+  if (info.currentBytesFromMalloc > info.maxBytesFromMalloc)
+  {
+    info.maxBytesFromMalloc = info.currentBytesFromMalloc;
+#ifdef __XMALLOC_HAVE_MMAP
+    if (info.currentBytesFromValloc > info.maxBytesSystem)
+      info.maxBytesSystem = info.currentBytesFromValloc;
+#endif
+  }
+#endif
+  return addr;
+}
+
 void* xReallocSizeFromSystem(void *addr, size_t oldSize, size_t newSize)
 {
-  void *newAddr = realloc(addr, newSize);
+  void *newAddr = __XMALLOC_SYSTEM_REALLOC(addr, newSize);
   if (NULL == newAddr)
   {
-    newAddr = realloc(addr, newSize);
+    newAddr = __XMALLOC_SYSTEM_REALLOC(addr, newSize);
     if (NULL == newAddr)
     {
       printf("out of memory in realloc\n");
@@ -112,7 +146,7 @@ void xVfreeNoMmap(void *addr, size_t size)
 #ifndef __XMALLOC_NDEBUG
   info.currentBytesFromMalloc -=  size;
 #endif
-  free(addr);
+  __XMALLOC_SYSTEM_FREE(addr);
 }
 
 void xFreeSizeToSystem(void *addr, size_t size)
@@ -120,7 +154,7 @@ void xFreeSizeToSystem(void *addr, size_t size)
 #ifndef __XMALLOC_NDEBUG
   info.currentBytesFromMalloc -=  size;
 #endif
-  free(addr);
+  __XMALLOC_SYSTEM_FREE(addr);
 }
 
 void* xVallocMmap(size_t size)
@@ -140,5 +174,26 @@ void* xVallocNoMmap(size_t size)
 #ifndef __XMALLOC_NDEBUG
   info.currentBytesFromMalloc +=  size;
 #endif
-  return valloc(size);
+  return __XMALLOC_SYSTEM_VALLOC(size);
+}
+
+void* xVreallocFromSystem(void *addr, size_t oldSize, size_t newSize)
+{
+  void *newAddr;
+  __XMALLOC_ASSERT(xIsAddrPageAligned(addr));
+#if defined(__XMALLOC_HAVE_MREMAP) && defined(__XMALLOC_HAVE_MMAP)
+  newAddr = mremap(addr, oldSize, newSize, MREMAP_MAYMOVE);
+  if (MAP_FAILED == newAddr)
+    return NULL;
+#ifndef __XMALLOC_NDEBUG
+  info.currentBytesFromMalloc +=  (long) newSize - (long) oldSize;
+#endif
+#else
+  newAddr = __XMALLOC_VALLOC(newSize);
+  if (NULL == newAddr)
+    return NULL;
+  memcpy(newAddr, addr, (oldSize < newSize ? oldSize : newSize));
+  __XMALLOC_VFREE(addr, oldSize);
+#endif
+  return newAddr;
 }
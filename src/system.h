@@ -19,6 +19,31 @@
 #include "xmalloc-config.h"
 #include "align.h"
 
+/**
+ * \brief Calls of the system allocator. The preload library exports malloc()
+ * and friends itself and must not end up in them again, so it calls the
+ * functions of the C library it resolves at startup, see preload.c.
+ */
+#ifdef __XMALLOC_PRELOAD
+extern void* (*xSystemMalloc)(size_t size);
+extern void* (*xSystemRealloc)(void *addr, size_t size);
+extern void  (*xSystemFree)(void *addr);
+extern void* (*xSystemMemalign)(size_t alignment, size_t size);
+extern void* (*xSystemCalloc)(size_t number, size_t size);
+#define __XMALLOC_SYSTEM_MALLOC(size)         xSystemMalloc((size))
+#define __XMALLOC_SYSTEM_CALLOC(number, size) xSystemCalloc((number), (size))
+#define __XMALLOC_SYSTEM_REALLOC(addr, size)  xSystemRealloc((addr), (size))
+#define __XMALLOC_SYSTEM_FREE(addr)           xSystemFree((addr))
+#define __XMALLOC_SYSTEM_VALLOC(size)                                 \
+  xSystemMemalign(__XMALLOC_SIZEOF_SYSTEM_PAGE, (size))
+#else
+#define __XMALLOC_SYSTEM_MALLOC(size)         malloc((size))
+#define __XMALLOC_SYSTEM_CALLOC(number, size) calloc((number), (size))
+#define __XMALLOC_SYSTEM_REALLOC(addr, size)  realloc((addr), (size))
+#define __XMALLOC_SYSTEM_FREE(addr)           free((addr))
+#define __XMALLOC_SYSTEM_VALLOC(size)         valloc((size))
+#endif
+
 /**
  * \fn void* xAllocFromSystem(size_t size)
  *
@@ -31,6 +56,20 @@
  */
 void* xAllocFromSystem(size_t size);
 
+/**
+ * \fn void* xAlloc0FromSystem(size_t size)
+ *
+ * \brief Allocates memory chunk of size \c size from the system and
+ * initializes it to zero. The system calloc() does not clear fresh pages,
+ * which are zero already.
+ *
+ * \param size size of the memory chunk
+ *
+ * \return address of allocated memory
+ *
+ */
+void* xAlloc0FromSystem(size_t size);
+
 /**
  * \fn void* xReallocSizeFromSystem(void *addr, size_t oldSize, size_t newSize)
  *
@@ -127,5 +166,25 @@ void xVfreeNoMmap(void *addr, size_t size);
  */
 void xFreeSizeToSystem(void *addr, size_t size);
 
+/**
+ * \fn void* xVreallocFromSystem(void *addr, size_t oldSize, size_t newSize)
+ *
+ * \brief Resizes the page aligned memory chunk of \c oldSize bytes at
+ * \c addr from \c __XMALLOC_VALLOC to \c newSize bytes. With mmap and
+ * mremap() the kernel moves the pages if the chunk cannot be resized in
+ * place, so the contents are not copied.
+ *
+ * \param addr page aligned address of the memory chunk
+ *
+ * \param oldSize size of the memory chunk, a multiple of the page size
+ *
+ * \param newSize new size of the memory chunk, a multiple of the page size
+ *
+ * \return address of the resized memory chunk, NULL if no memory is
+ * available; then the chunk at \c addr is untouched
+ *
+ */
+void* xVreallocFromSystem(void *addr, size_t oldSize, size_t newSize);
+
 
 #endif
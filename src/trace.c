@@ -0,0 +1,160 @@
+/**
+ * \file   trace.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Source file for slow-path event tracing in xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "src/system.h"
+#include "src/trace.h"
+
+#ifdef __XMALLOC_TRACE
+__thread xTraceBuffer xTraceLocalBuffer __XMALLOC_TLS_MODEL = NULL;
+
+static xTraceBuffer volatile xTraceBuffers  = NULL;
+static volatile unsigned int xTraceNumberThreads = 0;
+static volatile unsigned int xTraceNumberBuffers = 0;
+
+static pthread_key_t xTraceKey;
+static pthread_once_t xTraceKeyOnce = PTHREAD_ONCE_INIT;
+
+/* called when a thread with a buffer exits, the buffer is handed over to the
+ * next thread registering */
+static void xTraceUnregisterThread(void *buffer)
+{
+  __sync_synchronize();
+  ((xTraceBuffer) buffer)->unused = 1;
+}
+
+static void xTraceCreateKey()
+{
+  pthread_key_create(&xTraceKey, xTraceUnregisterThread);
+}
+
+xTraceBuffer xTraceRegisterThread()
+{
+  xTraceBuffer buffer;
+  xTraceBuffer root;
+
+  pthread_once(&xTraceKeyOnce, xTraceCreateKey);
+  // take over the buffer of an exited thread
+  for (buffer = xTraceBuffers; NULL != buffer; buffer = buffer->next)
+  {
+    if (buffer->unused && __sync_bool_compare_and_swap(&buffer->unused, 1, 0))
+    {
+      buffer->thread  = __sync_fetch_and_add(&xTraceNumberThreads, 1);
+      break;
+    }
+  }
+  if (NULL == buffer)
+  {
+    buffer          = xAllocFromSystem(sizeof(xTraceBufferType));
+    buffer->head    = 0;
+    buffer->unused  = 0;
+    // counted before the thread number is taken, see xTraceFlush()
+    __sync_fetch_and_add(&xTraceNumberBuffers, 1);
+    buffer->thread  = __sync_fetch_and_add(&xTraceNumberThreads, 1);
+    // lock-free push onto the global list of buffers
+    do
+    {
+      root          = xTraceBuffers;
+      buffer->next  = root;
+    } while (!__sync_bool_compare_and_swap(&xTraceBuffers, root, buffer));
+  }
+
+  pthread_setspecific(xTraceKey, buffer);
+  xTraceLocalBuffer = buffer;
+  return buffer;
+}
+
+static int xTraceCompareEvents(const void *a, const void *b)
+{
+  const xTraceEventType *e1 = a;
+  const xTraceEventType *e2 = b;
+  if (e1->tsc < e2->tsc)
+    return -1;
+  return (e1->tsc > e2->tsc);
+}
+
+long xTraceFlush(const char *fileName)
+{
+  xTraceHeader header;
+  xTraceBuffer buffer;
+  xTraceEvent events;
+  unsigned long numberEvents = 0, i, first, head;
+  unsigned int numberThreads  = xTraceNumberThreads;
+  unsigned int numberBuffers;
+  size_t size;
+  FILE *file;
+
+  // collect the events of all threads, threads registering meanwhile are
+  // not taken into account: each buffer with a thread number below
+  // numberThreads was counted in xTraceNumberBuffers before
+  __sync_synchronize();
+  numberBuffers = xTraceNumberBuffers;
+  size    = numberBuffers * __XMALLOC_TRACE_BUFFER_SIZE *
+              sizeof(xTraceEventType) + 1;
+  events  = xAllocFromSystem(size);
+  for (buffer = xTraceBuffers; NULL != buffer; buffer = buffer->next)
+  {
+    unsigned long start = numberEvents;
+    if (buffer->thread >= numberThreads)
+      continue;
+    head  = buffer->head;
+    __sync_synchronize();
+    first = (head > __XMALLOC_TRACE_BUFFER_SIZE ?
+              head - __XMALLOC_TRACE_BUFFER_SIZE : 0);
+    for (i = first; i < head; i++)
+      events[numberEvents++] =
+        buffer->events[i & (__XMALLOC_TRACE_BUFFER_SIZE - 1)];
+    // drop the events the owning thread might have overwritten meanwhile,
+    // including the one at head - __XMALLOC_TRACE_BUFFER_SIZE whose slot it
+    // may be writing right now
+    __sync_synchronize();
+    head  = buffer->head;
+    if (head + 1 > __XMALLOC_TRACE_BUFFER_SIZE &&
+        head + 1 - __XMALLOC_TRACE_BUFFER_SIZE > first)
+    {
+      unsigned long lost  = head + 1 - __XMALLOC_TRACE_BUFFER_SIZE - first;
+      if (lost > numberEvents - start)
+        lost  = numberEvents - start;
+      memmove(events + start, events + start + lost,
+          (numberEvents - start - lost) * sizeof(xTraceEventType));
+      numberEvents  -=  lost;
+    }
+  }
+  qsort(events, numberEvents, sizeof(xTraceEventType), xTraceCompareEvents);
+
+  memcpy(header.magic, __XMALLOC_TRACE_MAGIC, sizeof(header.magic));
+  header.eventSize      = sizeof(xTraceEventType);
+  header.numberThreads  = numberThreads;
+  header.ticksPerNs     = xTscTicksPerNanosecond();
+  header.numberEvents   = numberEvents;
+
+  file  = fopen(fileName, "wb");
+  if (NULL == file ||
+      1 != fwrite(&header, sizeof(header), 1, file) ||
+      numberEvents != fwrite(events, sizeof(xTraceEventType), numberEvents,
+                        file))
+  {
+    if (NULL != file)
+      fclose(file);
+    xFreeSizeToSystem(events, size);
+    return -1;
+  }
+  fclose(file);
+  xFreeSizeToSystem(events, size);
+  return (long) numberEvents;
+}
+#else
+long xTraceFlush(const char *fileName)
+{
+  return -1;
+}
+#endif
@@ -0,0 +1,178 @@
+/**
+ * \file   trace.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Slow-path event tracing for xmalloc. If xmalloc is configured with
+ *         --enable-trace, each thread records slow-path events into its own
+ *         lock-free ring buffer. The buffers can be flushed to a file which
+ *         is converted to Chrome trace JSON by tools/xtrace2json.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_TRACE_H
+#define XMALLOC_TRACE_H
+
+#include <stdlib.h>
+#include "xmalloc-config.h"
+#include "tsc.h"
+
+/**
+ * \brief Number of events kept per thread, must be a power of two. Older
+ * events are overwritten.
+ */
+#ifndef __XMALLOC_TRACE_BUFFER_SIZE
+#define __XMALLOC_TRACE_BUFFER_SIZE 8192
+#endif
+
+/**
+ * \brief Magic string at the beginning of a flushed trace file.
+ */
+#define __XMALLOC_TRACE_MAGIC "XMTRACE1"
+
+enum xTraceKind_e {
+  xTrace_PageRefill = 0,  /**< xAllocFromFullPage: arg0 = bin, arg1 = page */
+  xTrace_PageRelease,     /**< xFreeToPageFault: arg0 = page, arg1 = number
+                               of pages given back to the region */
+  xTrace_RegionMap,       /**< xAllocNewRegion: arg0 = address,
+                               arg1 = number of pages */
+  xTrace_RegionUnmap,     /**< xFreeRegion: arg0 = address,
+                               arg1 = number of pages */
+  xTrace_PageIndexFault,  /**< xPageIndexFault: arg0 = start index,
+                               arg1 = end index */
+  xTrace_LargeMalloc,     /**< large block from the system: arg0 = address
+                               returned to the caller, arg1 = size */
+  xTrace_SpecBinCreate,   /**< xGetSpecBin: arg0 = bin, arg1 = size */
+  xTrace_MaxKind
+};
+
+struct xTraceEventStruct;
+typedef struct xTraceEventStruct    xTraceEventType;
+typedef xTraceEventType*            xTraceEvent;
+
+struct xTraceBufferStruct;
+typedef struct xTraceBufferStruct   xTraceBufferType;
+typedef xTraceBufferType*           xTraceBuffer;
+
+/**
+ * \struct xTraceEventStruct
+ *
+ * \brief One recorded slow-path event. This is also the on-disk layout of
+ * the events in a flushed trace file.
+ */
+struct xTraceEventStruct {
+  unsigned long long  tsc;    /**< time stamp counter at recording time */
+  unsigned long long  arg0;   /**< first argument, see \c xTraceKind_e */
+  unsigned long long  arg1;   /**< second argument, see \c xTraceKind_e */
+  unsigned int        kind;   /**< kind of event, see \c xTraceKind_e */
+  unsigned int        thread; /**< number of the recording thread */
+};
+
+/**
+ * \struct xTraceBufferStruct
+ *
+ * \brief Per-thread ring buffer of events. Only the owning thread writes to
+ * it, \c head is published after the event is written.
+ */
+struct xTraceBufferStruct {
+  xTraceBuffer            next;   /**< next registered buffer */
+  unsigned int            thread; /**< number of the owning thread */
+  volatile int            unused; /**< set when the owning thread exited, the
+                                       buffer is taken over by the next
+                                       thread registering */
+  volatile unsigned long  head;   /**< number of events recorded so far */
+  xTraceEventType events[__XMALLOC_TRACE_BUFFER_SIZE]; /**< the ring */
+};
+
+/**
+ * \struct xTraceHeaderStruct
+ *
+ * \brief Header of a flushed trace file, followed by \c numberEvents
+ * \c xTraceEventStruct entries sorted by time stamp.
+ */
+struct xTraceHeaderStruct {
+  char                magic[8];         /**< __XMALLOC_TRACE_MAGIC */
+  unsigned int        eventSize;        /**< sizeof(xTraceEventType) */
+  unsigned int        numberThreads;    /**< number of registered threads */
+  double              ticksPerNs;       /**< time stamp ticks per ns */
+  unsigned long long  numberEvents;     /**< number of events in the file */
+};
+
+typedef struct xTraceHeaderStruct xTraceHeader;
+
+#ifdef __XMALLOC_TRACE
+extern __thread xTraceBuffer xTraceLocalBuffer __XMALLOC_TLS_MODEL;
+
+/**
+ * \fn xTraceBuffer xTraceRegisterThread()
+ *
+ * \brief Gets the ring buffer of the calling thread: The buffer of a thread
+ * which exited is reused, otherwise a new one is allocated and registered in
+ * the global list of buffers. Buffers stay in the list, so flushing need
+ * not synchronize with exiting threads, the events of an exited thread are
+ * kept until the new owner overwrites them.
+ *
+ * \return ring buffer of the calling thread
+ *
+ */
+xTraceBuffer xTraceRegisterThread();
+
+/**
+ * \fn static inline void xTraceRecord(unsigned int kind,
+ * unsigned long long arg0, unsigned long long arg1)
+ *
+ * \brief Records an event of type \c kind in the ring buffer of the calling
+ * thread.
+ *
+ * \param kind \c xTraceKind_e of the event
+ *
+ * \param arg0 first argument of the event
+ *
+ * \param arg1 second argument of the event
+ *
+ */
+static inline void xTraceRecord(unsigned int kind, unsigned long long arg0,
+    unsigned long long arg1)
+{
+  xTraceBuffer buffer = xTraceLocalBuffer;
+  unsigned long head;
+  xTraceEvent event;
+
+  if (NULL == buffer)
+    buffer  = xTraceRegisterThread();
+
+  head          = buffer->head;
+  event         = &buffer->events[head & (__XMALLOC_TRACE_BUFFER_SIZE - 1)];
+  event->tsc    = xReadTsc();
+  event->arg0   = arg0;
+  event->arg1   = arg1;
+  event->kind   = kind;
+  event->thread = buffer->thread;
+  // publish the event only after it is completely written
+  __asm__ __volatile__ ("" ::: "memory");
+  buffer->head  = head + 1;
+}
+
+#define __XMALLOC_TRACE_EVENT(kind, arg0, arg1)                     \
+  xTraceRecord((kind), (unsigned long long) (unsigned long) (arg0), \
+      (unsigned long long) (unsigned long) (arg1))
+#else
+#define __XMALLOC_TRACE_EVENT(kind, arg0, arg1) ((void) 0)
+#endif
+
+/**
+ * \fn long xTraceFlush(const char *fileName)
+ *
+ * \brief Writes the events currently stored in all ring buffers to the file
+ * \c fileName . Events still being written by other threads are skipped, the
+ * ring buffers are not reset.
+ *
+ * \param fileName name of the trace file
+ *
+ * \return number of events written, -1 if the file could not be written or
+ * xmalloc is not configured with --enable-trace
+ *
+ */
+long xTraceFlush(const char *fileName);
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * \file   tsc.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Source file for time stamp calibration in xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <time.h>
+#include "src/tsc.h"
+
+static double xTscTicks = 0.0;
+
+double xTscTicksPerNanosecond()
+{
+  struct timespec start, end;
+  unsigned long long tscStart, tscEnd;
+  long long ns;
+
+  if (xTscTicks > 0.0)
+    return xTscTicks;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  tscStart  = xReadTsc();
+  do
+  {
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns  = (long long) (end.tv_sec - start.tv_sec) * 1000000000LL +
+          (end.tv_nsec - start.tv_nsec);
+  } while (ns < 10000000LL);
+  tscEnd    = xReadTsc();
+
+  xTscTicks = (double) (tscEnd - tscStart) / (double) ns;
+  if (xTscTicks <= 0.0)
+    xTscTicks = 1.0;
+  return xTscTicks;
+}
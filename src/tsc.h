@@ -0,0 +1,49 @@
+/**
+ * \file   tsc.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Cheap timestamps for xmalloc's tracing and profiling facilities.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_TSC_H
+#define XMALLOC_TSC_H
+
+#include <time.h>
+#include "xmalloc-config.h"
+
+/**
+ * \fn static inline unsigned long long xReadTsc()
+ *
+ * \brief Reads the time stamp counter of the cpu. On architectures without
+ * such a counter a monotonic clock in nanoseconds is returned instead.
+ *
+ * \return current time stamp
+ *
+ */
+static inline unsigned long long xReadTsc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int lo, hi;
+  __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+  return ((unsigned long long) hi << 32) | lo;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * \fn double xTscTicksPerNanosecond()
+ *
+ * \brief Calibrates \c xReadTsc() against the monotonic clock. The first
+ * call takes about 10 milliseconds, afterwards the cached value is returned.
+ *
+ * \return number of time stamp ticks per nanosecond
+ *
+ */
+double xTscTicksPerNanosecond();
+
+#endif
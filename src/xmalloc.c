@@ -47,12 +47,69 @@ void* xGetNewPage() {
 /************************************************
  * SPEC-BIN STUFF
  ***********************************************/
-xBin xGetSpecBin(size_t size)
+/* the table is at most half full, so linear probing stays short */
+static void xInsertSpecBin(xSpecBin sBin)
+{
+  xSpecBin *oldTable      = xSpecBinTable;
+  unsigned long oldSize   = xSpecBinTableSize;
+  unsigned long i, j;
+
+  if (2 * (xNumberSpecBins + 1) > xSpecBinTableSize)
+  {
+    xSpecBinTableSize = (0 == oldSize ? 16 : 2 * oldSize);
+    xSpecBinTable     = (xSpecBin *) xMalloc0Sized(xSpecBinTableSize *
+                          sizeof(xSpecBin));
+    for (j = 0; j < oldSize; j++)
+    {
+      if (NULL == oldTable[j])
+        continue;
+      i = xSpecBinSlot(oldTable[j]->bin.numberBlocks);
+      while (NULL != xSpecBinTable[i])
+        i = (i + 1) & (xSpecBinTableSize - 1);
+      xSpecBinTable[i]  = oldTable[j];
+    }
+    if (NULL != oldTable)
+      xFreeSized(oldTable, oldSize * sizeof(xSpecBin));
+  }
+  i = xSpecBinSlot(sBin->bin.numberBlocks);
+  while (NULL != xSpecBinTable[i])
+    i = (i + 1) & (xSpecBinTableSize - 1);
+  xSpecBinTable[i]  = sBin;
+  xNumberSpecBins++;
+}
+
+/* the entries behind the removed one are moved back into the gap if their
+ * first slot allows it, so no lookup ends too early */
+static void xRemoveSpecBin(xSpecBin sBin)
+{
+  unsigned long mask  = xSpecBinTableSize - 1;
+  unsigned long i, j, k;
+
+  i = xSpecBinSlot(sBin->bin.numberBlocks);
+  while (xSpecBinTable[i] != sBin)
+    i = (i + 1) & mask;
+  xSpecBinTable[i]  = NULL;
+  xNumberSpecBins--;
+  for (j = (i + 1) & mask; NULL != xSpecBinTable[j]; j = (j + 1) & mask)
+  {
+    k = xSpecBinSlot(xSpecBinTable[j]->bin.numberBlocks);
+    // the entry stays if its first slot lies cyclically in (i, j]
+    if ((i < j ? (i < k && k <= j) : (i < k || k <= j)))
+      continue;
+    xSpecBinTable[i]  = xSpecBinTable[j];
+    xSpecBinTable[j]  = NULL;
+    i = j;
+  }
+}
+
+static xBin xDoGetSpecBin(size_t size)
 {
   xBin newSpecBin;
   long numberBlocks;
   long sizeInWords;
+  long spanSize;
 
+  __XMALLOC_PROBE1(specbin__get, size);
   size  = xAlignSize(size);
   if (size > __XMALLOC_SIZEOF_PAGE)
   {
@@ -71,15 +128,18 @@ xBin xGetSpecBin(size_t size)
   else
   {
     // small memory chunks
-    // reserve memory for page header
-    numberBlocks  = __XMALLOC_SIZEOF_PAGE / size;
+    // reserve memory for page header, pages of blocks larger than the ones
+    // of the static bins span several system pages
+    spanSize      = xSpanPagesOfSize(size) * __XMALLOC_SIZEOF_SYSTEM_PAGE -
+                      __XMALLOC_SIZEOF_PAGE_HEADER;
+    numberBlocks  = spanSize / size;
 
-    sizeInWords   = (__XMALLOC_SIZEOF_PAGE % size) / numberBlocks;
+    sizeInWords   = (spanSize % size) / numberBlocks;
     sizeInWords   = ((size + sizeInWords) &
       ~(__XMALLOC_SIZEOF_ALIGNMENT_MINUS_ONE));
 
     __XMALLOC_ASSERT(sizeInWords >= size);
-    __XMALLOC_ASSERT(numberBlocks * sizeInWords <= __XMALLOC_SIZEOF_PAGE);
+    __XMALLOC_ASSERT(numberBlocks * sizeInWords <= spanSize);
 
     sizeInWords = sizeInWords >> __XMALLOC_LOG_SIZEOF_ALIGNMENT;
 
@@ -91,30 +151,30 @@ xBin xGetSpecBin(size_t size)
   if (__XMALLOC_LARGE_BIN == newSpecBin ||
       numberBlocks > newSpecBin->numberBlocks)
   {
-    xSpecBin specBin  = xFindInSortedList(xBaseSpecBin, numberBlocks);
-    // we get a specBin from the list search in above
+    xSpecBin specBin  = xFindSpecBin(numberBlocks, sizeInWords);
+    // we get a specBin from the table
     if (NULL != specBin)
     {
       (specBin->ref)++;
-      __XMALLOC_ASSERT(NULL != specBin->bin &&
-          specBin->bin->numberBlocks  ==  specBin->numberBlocks &&
-          specBin->bin->sizeInWords   ==  sizeInWords);
-      return specBin->bin;
+      __XMALLOC_ASSERT(specBin->bin.sizeInWords == sizeInWords);
+      return &specBin->bin;
     }
-    // we do not get a specBin from the above list, thus we have to allocate and
-    // register it by hand
-    specBin               = (xSpecBin) xMalloc(sizeof(xSpecBinType));
+    // we do not get a specBin from the table, thus we have to allocate and
+    // register it by hand: bin and reference counter share one cache line
+    specBin               = (xSpecBin) xMallocAligned(sizeof(xSpecBinType),
+                              __XMALLOC_CPU_CACHE_LINE);
     specBin->ref          = 1;
-    specBin->next         = NULL;
-    specBin->numberBlocks = numberBlocks;
-    specBin->bin          = (xBin) xMalloc(sizeof(xBinType));
-    specBin->bin->currentPage   = __XMALLOC_ZERO_PAGE;
-    specBin->bin->lastPage      = NULL;
-    specBin->bin->sizeInWords   = sizeInWords;
-    specBin->bin->numberBlocks  = numberBlocks;
-    specBin->bin->sticky        = 0;
-    xBaseSpecBin  = xInsertIntoSortedList(xBaseSpecBin, specBin, numberBlocks);
-    return specBin->bin;
+    specBin->bin.currentPage  = __XMALLOC_ZERO_PAGE;
+    specBin->bin.lastPage     = NULL;
+    specBin->bin.next         = NULL;
+    specBin->bin.sizeInWords  = sizeInWords;
+    specBin->bin.numberBlocks = numberBlocks;
+    specBin->bin.sticky       = 0;
+    specBin->bin.zero         = NULL;
+    xInsertSpecBin(specBin);
+    __XMALLOC_TRACE_EVENT(xTrace_SpecBinCreate, &specBin->bin, size);
+    __XMALLOC_PROBE3(specbin__new, &specBin->bin, size, numberBlocks);
+    return &specBin->bin;
   }
   else
   {
@@ -122,31 +182,38 @@ xBin xGetSpecBin(size_t size)
   }
 }
 
+xBin xGetSpecBin(size_t size)
+{
+  xBin bin;
+  __XMALLOC_RECORD_SUSPEND();
+  bin = xDoGetSpecBin(size);
+  __XMALLOC_RECORD_RESUME();
+  __XMALLOC_RECORD_GET_SPEC_BIN(bin, size);
+  return bin;
+}
+
 void xUnGetSpecBin(xBin *oldBin, int remove)
 {
   xBin bin  = *oldBin;
-  if (!xIsStaticBin(bin))
+  xSpecBin sBin;
+  __XMALLOC_RECORD_SUSPEND();
+  // aligned and sticky bins are neither static nor registered spec bins
+  sBin  = (xIsStaticBin(bin) ? NULL :
+            xFindSpecBin(bin->numberBlocks, bin->sizeInWords));
+  if (NULL != sBin && &sBin->bin == bin)
   {
-    xSpecBin sBin = xFindInSortedList(xBaseSpecBin, bin->numberBlocks);
-
-    __XMALLOC_ASSERT(NULL != sBin);
-    __XMALLOC_ASSERT(bin == sBin->bin);
-
-    if (NULL != sBin)
+    sBin->ref--;
+    if (0 == sBin->ref || remove)
     {
-      sBin->ref--;
-      if (0 == sBin->ref || remove)
+      //xFreeKeptAddrFromBin(sBin->bin);
+      if (NULL == sBin->bin.lastPage || remove)
       {
-        //xFreeKeptAddrFromBin(sBin->bin);
-        if (NULL == sBin->bin->lastPage || remove)
-        {
-          xBaseSpecBin  = xRemoveFromSortedList(xBaseSpecBin, sBin);
-          xFreeSize(sBin->bin, sizeof(xBinType));
-          xFreeSize(sBin, sizeof(xSpecBinType));
-        }
+        xRemoveSpecBin(sBin);
+        xFreeSize(sBin, sizeof(xSpecBinType));
       }
     }
   }
+  __XMALLOC_RECORD_RESUME();
   *oldBin = NULL;
 }
 
@@ -200,22 +267,253 @@ void xFreeBinRegion(xRegion reg, void *ptr) {
   }
 }
 */
+/************************************************
+ * IN-PLACE REALLOCATION
+ ***********************************************/
+/* a block of blockSize bytes is kept for newSize bytes if they fit and a
+ * fresh block of newSize would not save more than __XMALLOC_REALLOC_MAX_WASTE
+ * percent of it, so shrinking within a bin or to a slightly smaller size
+ * class does not copy */
+static inline int xReallocKeepsBlock(size_t blockSize, size_t newSize)
+{
+  size_t freshSize;
+  if (newSize > blockSize)
+    return 0;
+  if (newSize > __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+    freshSize = newSize;
+  else
+    freshSize = xSmallSize2Bin(newSize)->sizeInWords <<
+                  __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+  return (blockSize - freshSize) * 100 <=
+          blockSize * __XMALLOC_REALLOC_MAX_WASTE;
+}
+
+/************************************************
+ * ALIGNED BINS
+ ***********************************************/
+xBin xGetAlignedBin(size_t size, size_t alignment)
+{
+  unsigned long logAlignment  = __builtin_ctzl(alignment);
+  unsigned long index         = (size - 1) >> logAlignment;
+  size_t blockSize            = (index + 1) << logAlignment;
+  xBin bin;
+
+  __XMALLOC_ASSERT(xIsAlignment(alignment) && alignment >= 32 &&
+      alignment <= __XMALLOC_MAX_BIN_ALIGNMENT);
+  __XMALLOC_ASSERT(0 < size && size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  if (NULL != xAlignedBin[logAlignment - 5][index])
+    return xAlignedBin[logAlignment - 5][index];
+
+  bin = NULL;
+  if (blockSize <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+    bin = xSmallSize2Bin(blockSize);
+  if (NULL == bin ||
+      (bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT) != blockSize)
+  {
+    bin               = (xBin) xMalloc(sizeof(xBinType));
+    bin->currentPage  = __XMALLOC_ZERO_PAGE;
+    bin->lastPage     = NULL;
+    bin->next         = NULL;
+    bin->sizeInWords  = blockSize >> __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+    bin->numberBlocks = (__XMALLOC_SIZEOF_SYSTEM_PAGE -
+                          xAlignedPageHeaderSize(blockSize)) / blockSize;
+    bin->sticky       = 0;
+    bin->zero         = NULL;
+  }
+  xAlignedBin[logAlignment - 5][index] = bin;
+  return bin;
+}
+
+/************************************************
+ * ALIGNED LARGE MEMORY CHUNKS
+ ***********************************************/
+/* in front of the chunk there are, from the address downwards, the size
+ * marked by __XMALLOC_LARGE_ALIGNED, the offset to the address returned by
+ * the system and the number of bytes allocated from the system */
+void* xMallocAlignedLarge(const size_t size, const size_t alignment)
+{
+  size_t total  = size + alignment + 2 * __XMALLOC_SIZEOF_ALIGNMENT;
+  char *ptr, *addr;
+  __XMALLOC_ASSERT(xIsAlignment(alignment));
+
+  __XMALLOC_LATENCY_START(start);
+  // accounted as xFreeAlignedLarge() gives it back by xFreeSizeToSystem()
+  ptr   = (char*) xAllocFromSystem(total);
+  __XMALLOC_LATENCY_STOP(xLatency_LargeSystem, start);
+  addr  = (char*) (((unsigned long) ptr + 3 * __XMALLOC_SIZEOF_ALIGNMENT +
+                    alignment - 1) & ~((unsigned long) alignment - 1));
+  ((size_t *) addr)[-1] = size | __XMALLOC_LARGE_ALIGNED;
+  ((size_t *) addr)[-2] = addr - ptr;
+  ((size_t *) addr)[-3] = total;
+  __XMALLOC_TRACE_EVENT(xTrace_LargeMalloc, addr, size);
+  __XMALLOC_PROBE2(large__alloc, addr, size);
+  __XMALLOC_RECORD_MALLOC(addr, size);
+  return (void*) addr;
+}
+
+/************************************************
+ * HUGE MEMORY CHUNKS
+ ***********************************************/
+/* the mapping starts with the length of the mapping and the size marked by
+ * __XMALLOC_LARGE_HUGE, directly followed by the chunk */
+static inline size_t xHugeMappingSize(size_t size)
+{
+  return (size + 2 * __XMALLOC_SIZEOF_ALIGNMENT +
+          __XMALLOC_SIZEOF_SYSTEM_PAGE - 1) &
+          ~((size_t) __XMALLOC_SIZEOF_SYSTEM_PAGE - 1);
+}
+
+void* xMallocHuge(const size_t size)
+{
+  size_t length = xHugeMappingSize(size);
+  size_t *ptr;
+
+  __XMALLOC_LATENCY_START(start);
+  ptr = (size_t *) __XMALLOC_VALLOC(length);
+  __XMALLOC_LATENCY_STOP(xLatency_LargeSystem, start);
+  if (NULL == ptr)
+    return NULL;
+#ifndef __XMALLOC_HAVE_MMAP
+  memset(ptr, 0, length);
+#endif
+  ptr[0]  = length;
+  ptr[1]  = size | __XMALLOC_LARGE_HUGE;
+  __XMALLOC_TRACE_EVENT(xTrace_LargeMalloc, ptr + 2, size);
+  __XMALLOC_PROBE2(large__alloc, ptr + 2, size);
+  return (void *) (ptr + 2);
+}
+
+void* xReallocHuge(void *addr, const size_t newSize)
+{
+  size_t *ptr       = (size_t *) addr - 2;
+  size_t newLength  = xHugeMappingSize(newSize);
+
+  __XMALLOC_ASSERT(ptr[1] & __XMALLOC_LARGE_HUGE);
+  if (newLength != ptr[0])
+  {
+    size_t *newPtr  = (size_t *) xVreallocFromSystem(ptr, ptr[0], newLength);
+    if (NULL == newPtr)
+    {
+      // the chunk becomes an ordinary large one from the system malloc,
+      // xAllocFromSystem() handles running out of memory
+      size_t oldSize  = ptr[1] & ~__XMALLOC_LARGE_FLAGS;
+      size_t size     = xAlignSize(newSize);
+      newPtr    = (size_t *) xAllocFromSystem(size +
+                    __XMALLOC_SIZEOF_ALIGNMENT);
+      newPtr[0] = size;
+      memcpy(newPtr + 1, addr, (oldSize < newSize ? oldSize : newSize));
+      xFreeHuge(addr);
+      return (void *) (newPtr + 1);
+    }
+    ptr     = newPtr;
+    ptr[0]  = newLength;
+  }
+  ptr[1]  = newSize | __XMALLOC_LARGE_HUGE;
+  return (void *) (ptr + 2);
+}
+
+void xFreeHuge(void *addr)
+{
+  size_t *ptr = (size_t *) addr - 2;
+  __XMALLOC_ASSERT(ptr[1] & __XMALLOC_LARGE_HUGE);
+  __XMALLOC_VFREE(ptr, ptr[0]);
+}
+
+void xFreeAlignedLarge(void *addr)
+{
+  size_t *header  = (size_t *) addr;
+  __XMALLOC_ASSERT(header[-1] & __XMALLOC_LARGE_ALIGNED);
+  xFreeSizeToSystem((char *) addr - header[-2], header[-3]);
+}
+
 void* xReallocLarge(void *oldPtr, size_t newSize) {
-  newSize       = xAlignSize(newSize);
-  char *oldAddr = (char *)oldPtr - __XMALLOC_SIZEOF_ALIGNMENT;
+  if (*((size_t *) oldPtr - 1) & __XMALLOC_LARGE_HUGE)
+  {
+    // a huge chunk stays one as long as it is not much smaller
+    if (newSize >= __XMALLOC_HUGE_BLOCK_SIZE / 2)
+      return xReallocHuge(oldPtr, newSize);
+    else
+    {
+      void *newPtr  = xMalloc(newSize);
+      memcpy(newPtr, oldPtr, newSize);
+      xFreeHuge(oldPtr);
+      return newPtr;
+    }
+  }
+  if (newSize >= __XMALLOC_HUGE_BLOCK_SIZE)
+  {
+    // the last copy, further growth moves pages
+    size_t oldSize  = xSizeOfLargeAddr(oldPtr);
+    void *newPtr    = xMallocHuge(newSize);
+    if (NULL == newPtr)
+    {
+      // no mapping, the chunk stays an ordinary large one from the system
+      // malloc, xAllocFromSystem() handles running out of memory
+      size_t size = xAlignSize(newSize);
+      size_t *ptr = (size_t *) xAllocFromSystem(size +
+                      __XMALLOC_SIZEOF_ALIGNMENT);
+      ptr[0]  = size;
+      newPtr  = (void *) (ptr + 1);
+    }
+    memcpy(newPtr, oldPtr, (oldSize < newSize ? oldSize : newSize));
+    xFreeLargeAddr(oldPtr);
+    return newPtr;
+  }
+  if (*((size_t *) oldPtr - 1) & __XMALLOC_LARGE_ALIGNED)
+  {
+    // as realloc() the alignment is not kept
+    size_t oldSize  = xSizeOfLargeAddr(oldPtr);
+    void *newPtr    = xMalloc(newSize);
+    memcpy(newPtr, oldPtr, (oldSize < newSize ? oldSize : newSize));
+    xFreeAlignedLarge(oldPtr);
+    return newPtr;
+  }
+  newSize           = xAlignSize(newSize);
+  char *oldAddr     = (char *)oldPtr - __XMALLOC_SIZEOF_ALIGNMENT;
+  size_t allocated  = xAllocatedSizeOfLargeAddr(oldPtr);
+  if (xReallocKeepsBlock(allocated, newSize))
+  {
+    // the system block is not touched: in front of it the usable size is
+    // stored, behind that the allocated one xFreeLargeAddr() gives back
+    if (allocated - newSize >= __XMALLOC_SIZEOF_ALIGNMENT)
+    {
+      *((size_t *) oldAddr) = newSize | __XMALLOC_LARGE_SHRUNK;
+      *((size_t *) ((char *) oldPtr + newSize)) = allocated;
+    }
+    else
+    {
+      *((size_t *) oldAddr) = allocated;
+    }
+    return oldPtr;
+  }
   char *newAddr = xReallocSizeFromSystem(oldAddr,
-                    *((long *) oldAddr) + __XMALLOC_SIZEOF_ALIGNMENT,
+                    allocated + __XMALLOC_SIZEOF_ALIGNMENT,
                     newSize + __XMALLOC_SIZEOF_ALIGNMENT);
 
   *((size_t *) newAddr) = newSize;
   return (void *) (newAddr + __XMALLOC_SIZEOF_ALIGNMENT);
 }
 
-void* xRealloc0Large(void *oldPtr, size_t newSize) {
-  size_t oldSize  = xSizeOfLargeAddr(oldPtr);
-  char *newPtr    = xReallocLarge(oldPtr, newSize);
-
+void* xRealloc0Large(void *oldPtr, size_t oldSize, size_t newSize) {
+  size_t dirty;
+  char *newPtr;
+
+  // behind the size known to the caller there may be old contents, e.g. if
+  // the chunk was shrunk in place by less than a word before
+  if (oldSize > xSizeOfLargeAddr(oldPtr))
+    oldSize = xSizeOfLargeAddr(oldPtr);
+  dirty = oldSize;
+
+  // behind a huge chunk there may be old contents up to the end of its
+  // mapping, pages added by the system are zero
+  if (*((size_t *) oldPtr - 1) & __XMALLOC_LARGE_HUGE)
+    dirty = *((size_t *) oldPtr - 2) - 2 * __XMALLOC_SIZEOF_ALIGNMENT;
+  newPtr  = xReallocLarge(oldPtr, newSize);
   newSize = xSizeOfLargeAddr(newPtr);
+#ifdef __XMALLOC_HAVE_MMAP
+  if (*((size_t *) newPtr - 1) & __XMALLOC_LARGE_HUGE && newSize > dirty)
+    newSize = dirty;
+#endif
   // check if we need to initialize stuff to zero
   if (newSize > oldSize)
     memset(newPtr + oldSize, 0, newSize - oldSize);
@@ -223,13 +521,42 @@ void* xRealloc0Large(void *oldPtr, size_t newSize) {
   return (void *) newPtr;
 }
 
+void* xReallocSized(void *oldPtr, size_t oldSize, size_t newSize)
+{
+  void *newPtr  = NULL;
+  __XMALLOC_RECORD_SUSPEND();
+  if (oldSize > __XMALLOC_MAX_SMALL_BLOCK_SIZE &&
+      newSize > __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+  {
+    // both chunks come from the system which might extend it in place
+    newPtr  = xReallocSizeFromSystem(oldPtr, oldSize, newSize);
+  }
+  else if (oldSize <= __XMALLOC_MAX_SMALL_BLOCK_SIZE &&
+           newSize <= __XMALLOC_MAX_SMALL_BLOCK_SIZE &&
+           xReallocKeepsBlock(xSmallSize2Bin(oldSize)->sizeInWords <<
+             __XMALLOC_LOG_SIZEOF_ALIGNMENT, newSize))
+  {
+    newPtr  = oldPtr;
+  }
+  else
+  {
+    newPtr  = xMallocSized(newSize);
+    memcpy(newPtr, oldPtr, (oldSize < newSize ? oldSize : newSize));
+    xFreeSized(oldPtr, oldSize);
+  }
+  __XMALLOC_RECORD_RESUME();
+  __XMALLOC_RECORD_REALLOC(oldPtr, oldSize, newPtr, newSize);
+  return newPtr;
+}
+
 void* xDoRealloc(void *oldPtr, size_t oldSize, size_t newSize, int initZero)
 {
-  if(!xIsBinAddr(oldPtr) && newSize > __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+  if(!xIsBinAddr(oldPtr) && !xIsSpanAddr(oldPtr) &&
+     newSize > __XMALLOC_MAX_SMALL_BLOCK_SIZE)
   {
     // memory chunk is large, let system malloc handle it
     if (initZero)
-      return xRealloc0Large(oldPtr, newSize);
+      return xRealloc0Large(oldPtr, oldSize, newSize);
     else
       return xReallocLarge(oldPtr, newSize);
   }
@@ -238,8 +565,10 @@ void* xDoRealloc(void *oldPtr, size_t oldSize, size_t newSize, int initZero)
     // memory chunk is small enough, xmalloc handles it
     void *newPtr    = xMalloc(newSize);
     size_t minSize  = (oldSize < newSize ? oldSize : newSize);
-    //memcpy(newPtr, oldPtr, minSize >> __XMALLOC_LOG_SIZEOF_LONG);
-    memcpy(newPtr, oldPtr, minSize);
+    // one of the chunks is a block of a bin, the other one is larger than
+    // any block, so both hold minSize rounded up to whole words
+    xCopyBlock(newPtr, oldPtr, (minSize + __XMALLOC_SIZEOF_ALIGNMENT_MINUS_ONE)
+        >> __XMALLOC_LOG_SIZEOF_ALIGNMENT);
 
     // initialize with 0 if initZero is set
     if ((initZero)&&(newSize>oldSize))
@@ -254,16 +583,21 @@ void* xDoRealloc(void *oldPtr, size_t oldSize, size_t newSize, int initZero)
 
 void* xReallocSize(void *oldPtr, size_t oldSize, size_t newSize) {
   void *newPtr  = NULL;
-  if (__XMALLOC_MAX(newSize, oldSize) <= __XMALLOC_MAX_SMALL_BLOCK_SIZE) {
+  __XMALLOC_RECORD_SUSPEND();
+  if ((oldSize <= __XMALLOC_MAX_SMALL_BLOCK_SIZE || xIsBinAddr(oldPtr)) &&
+      xReallocKeepsBlock(xSizeOfBinAddr(oldPtr), newSize)) {
+    // the block is large enough and not too large
+    newPtr  = oldPtr;
+  } else if (__XMALLOC_MAX(newSize, oldSize) <=
+             __XMALLOC_MAX_SMALL_BLOCK_SIZE) {
     xBin oldBin = xGetBinOfAddr(oldPtr);
     xBin newBin = xSmallSize2Bin(newSize);
 
     if (oldBin != newBin) {
       newPtr  = xAllocFromBin(newBin);
-      //memcpy(newPtr, oldPtr, (newBin->sizeInWords > oldWordSize ? oldWordSize :
-      //        newBin->sizeInWords));
-      memcpy(newPtr, oldPtr, (newSize> oldSize ? oldSize :
-              newSize));
+      // both blocks hold the words of the smaller one
+      xCopyBlock(newPtr, oldPtr, (newBin->sizeInWords > oldBin->sizeInWords ?
+              oldBin->sizeInWords : newBin->sizeInWords));
       xFreeBinAddr(oldPtr);
     } else {
       newPtr  = oldPtr;
@@ -271,30 +605,43 @@ void* xReallocSize(void *oldPtr, size_t oldSize, size_t newSize) {
   } else {
     newPtr  = xDoRealloc(oldPtr, oldSize, newSize, 0);
   }
+  __XMALLOC_RECORD_RESUME();
+  __XMALLOC_RECORD_REALLOC(oldPtr, oldSize, newPtr, newSize);
   return newPtr;
 }
 
 void* xRealloc0Size(void *oldPtr, size_t oldSize, size_t newSize)
 {
   void *newPtr  = NULL;
-  if (__XMALLOC_MAX(newSize, oldSize) <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+  __XMALLOC_RECORD_SUSPEND();
+  if ((oldSize <= __XMALLOC_MAX_SMALL_BLOCK_SIZE || xIsBinAddr(oldPtr)) &&
+      xReallocKeepsBlock(xSizeOfBinAddr(oldPtr), newSize))
+  {
+    newPtr  = oldPtr;
+    if (newSize > oldSize)
+      memset((char *)newPtr + oldSize, 0, newSize - oldSize);
+  }
+  else if (__XMALLOC_MAX(newSize, oldSize) <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
   {
     xBin oldBin = xGetBinOfAddr(oldPtr);
     xBin newBin = xSmallSize2Bin(newSize);
 
     if (oldBin != newBin)
     {
+      size_t newBinSize = newBin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+      size_t oldBinSize = oldBin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+      void *zero        = newBin->zero;
       newPtr  = xAllocFromBin(newBin);
       __XMALLOC_ASSERT(NULL != newPtr);
-      newSize = newBin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
-      oldSize = oldBin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
-      memcpy(newPtr, oldPtr, (newSize> oldSize ? oldSize :
-              newSize));
+      xCopyBlock(newPtr, oldPtr, (newBinSize > oldBinSize ? oldBinSize :
+              newBinSize) >> __XMALLOC_LOG_SIZEOF_ALIGNMENT);
       xFreeBinAddr(oldPtr);
-      // initialize to zero if needed
-      if (newSize > oldSize)
+      // initialize to zero if needed, a fresh block is zero behind its link
+      // which is overwritten by the copy
+      if (newBinSize > oldBinSize && newPtr != zero)
       {
-        memset((char *)newPtr + oldSize, 0, newSize - oldSize);
+        xZeroBlock((char *)newPtr + oldBinSize,
+            (newBinSize - oldBinSize) >> __XMALLOC_LOG_SIZEOF_ALIGNMENT);
       }
     }
     else
@@ -306,6 +653,8 @@ void* xRealloc0Size(void *oldPtr, size_t oldSize, size_t newSize)
   {
     newPtr  = xDoRealloc(oldPtr, oldSize, newSize, 1);
   }
+  __XMALLOC_RECORD_RESUME();
+  __XMALLOC_RECORD_REALLOC(oldPtr, oldSize, newPtr, newSize);
   return newPtr;
 }
 
@@ -318,7 +667,10 @@ void xFreeSizeFunc(void *ptr, size_t size) {
  * STICKY BUSINESS OF BINS
  ***********************************************/
 xBin xGetStickyBinOfBin(xBin bin) {
-  xBin newBin = xMalloc(sizeof(xBinType));
+  xBin newBin;
+  __XMALLOC_RECORD_SUSPEND();
+  newBin      = xMalloc(sizeof(xBinType));
+  __XMALLOC_RECORD_RESUME();
   __XMALLOC_ASSERT(!xIsStickyBin(bin));
   newBin->sticky        = __XMALLOC_SIZEOF_VOIDP;
   newBin->numberBlocks  = bin->numberBlocks;
@@ -327,10 +679,135 @@ xBin xGetStickyBinOfBin(xBin bin) {
   xStickyBins           = newBin;
   newBin->lastPage      = NULL;
   newBin->currentPage   = __XMALLOC_ZERO_PAGE;
+  newBin->zero          = NULL;
 
   return newBin;
 }
 
+/* takes sBin out of the list of sticky bins */
+static void xRemoveStickyBin(xBin sBin)
+{
+  xBin *prev  = &xStickyBins;
+  while (*prev != sBin)
+  {
+    __XMALLOC_ASSERT(NULL != *prev);
+    prev  = &(*prev)->next;
+  }
+  *prev = sBin->next;
+}
+
+void xMergeStickyBinIntoBin(xBin sBin, xBin bin)
+{
+  xPage page, prev, full = NULL, fullLast = NULL;
+  xPage part = NULL, partLast = NULL;
+
+  __XMALLOC_ASSERT(xIsStickyBin(sBin));
+  __XMALLOC_ASSERT(!xIsStickyBin(bin));
+  __XMALLOC_ASSERT(sBin->sizeInWords == bin->sizeInWords);
+  __XMALLOC_ASSERT(sBin->numberBlocks == bin->numberBlocks);
+  // one pass over the pages from the last one: they get their new owner and
+  // are sorted into the full ones and the ones with free blocks, keeping
+  // their order
+  for (page = sBin->lastPage; NULL != page; page = prev)
+  {
+    prev  = page->prev;
+    xSetBinOfPage(page, bin);
+    if (NULL == page->current)
+    {
+      // as in xAllocFromFullPage() the first free moves the page behind the
+      // current one
+      page->numberUsedBlocks  = 0;
+      page->next              = full;
+      if (NULL == full)
+        fullLast  = page;
+      else
+        full->prev  = page;
+      full  = page;
+    }
+    else
+    {
+      page->next  = part;
+      if (NULL == part)
+        partLast  = page;
+      else
+        part->prev  = page;
+      part  = page;
+    }
+  }
+  if (NULL != full)
+    full->prev  = NULL;
+  if (NULL != part)
+    part->prev  = NULL;
+
+  if (__XMALLOC_ZERO_PAGE == bin->currentPage)
+  {
+    // bin is empty: the full pages come first, the current page is the first
+    // one with free blocks
+    if (NULL != full)
+    {
+      fullLast->next  = part;
+      if (NULL != part)
+        part->prev  = fullLast;
+      bin->currentPage  = (NULL != part ? part : fullLast);
+      bin->lastPage     = (NULL != part ? partLast : fullLast);
+    }
+    else if (NULL != part)
+    {
+      bin->currentPage  = part;
+      bin->lastPage     = partLast;
+    }
+  }
+  else
+  {
+    // full pages go in front of the current page, pages with free blocks
+    // behind it where xAllocFromFullPage() picks them up next
+    if (NULL != full)
+    {
+      full->prev      = bin->currentPage->prev;
+      fullLast->next  = bin->currentPage;
+      if (NULL != full->prev)
+        full->prev->next  = full;
+      bin->currentPage->prev  = fullLast;
+    }
+    if (NULL != part)
+    {
+      partLast->next  = bin->currentPage->next;
+      if (NULL != partLast->next)
+        partLast->next->prev  = partLast;
+      else
+        bin->lastPage = partLast;
+      part->prev              = bin->currentPage;
+      bin->currentPage->next  = part;
+    }
+  }
+  // bin->zero may point into a page released earlier and taken by sBin
+  // since, it must not be mistaken for a fresh block of a merged page
+  bin->zero = NULL;
+
+  xRemoveStickyBin(sBin);
+  __XMALLOC_RECORD_SUSPEND();
+  xFreeSize(sBin, sizeof(xBinType));
+  __XMALLOC_RECORD_RESUME();
+}
+
+void xUnGetStickyBinOfBin(xBin *sBin)
+{
+  xBin bin  = *sBin;
+  xPage page, prev;
+
+  __XMALLOC_ASSERT(xIsStickyBin(bin));
+  for (page = bin->lastPage; NULL != page; page = prev)
+  {
+    prev  = page->prev;
+    xFreePagesOfBin(page, bin);
+  }
+  xRemoveStickyBin(bin);
+  __XMALLOC_RECORD_SUSPEND();
+  xFreeSize(bin, sizeof(xBinType));
+  __XMALLOC_RECORD_RESUME();
+  *sBin = NULL;
+}
+
 /***********************************************
  * statistics
  **********************************************/
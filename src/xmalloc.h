@@ -28,13 +28,95 @@ extern "C" {
 #include "page.h"
 #include "bin.h"
 #include "region.h"
+#include "arena.h"
 #include "align.h"
+#include "trace.h"
+#include "probes.h"
+#include "histogram.h"
+#include "record.h"
 
 // needed exactly here
 extern xBin xSize2Bin[];
 #define xSmallSize2Bin(size)                              \
   xSize2Bin[((size)-1) >> __XMALLOC_LOG_SIZEOF_ALIGNMENT]
 
+/**
+ * \brief A reallocation keeps the block if it is large enough and a new block
+ * would not save more than this percentage of it.
+ */
+#define __XMALLOC_REALLOC_MAX_WASTE   25
+
+/**
+ * \brief Marks the size stored in front of a large memory chunk allocated by
+ * \c xMallocAlignedLarge() .
+ */
+#define __XMALLOC_LARGE_ALIGNED                           \
+  ((size_t) 1 << (__XMALLOC_BIT_SIZEOF_LONG - 1))
+
+/**
+ * \brief Marks the size stored in front of a huge memory chunk allocated by
+ * \c xMallocHuge() .
+ */
+#define __XMALLOC_LARGE_HUGE                              \
+  ((size_t) 1 << (__XMALLOC_BIT_SIZEOF_LONG - 2))
+
+/**
+ * \brief Marks the size stored in front of an ordinary large memory chunk
+ * which was shrunk in place by \c xReallocLarge() . The size is the usable
+ * one, the allocated size is stored in the word behind it, see
+ * \c xAllocatedSizeOfLargeAddr() .
+ */
+#define __XMALLOC_LARGE_SHRUNK                            \
+  ((size_t) 1 << (__XMALLOC_BIT_SIZEOF_LONG - 3))
+
+#define __XMALLOC_LARGE_FLAGS                             \
+  (__XMALLOC_LARGE_ALIGNED | __XMALLOC_LARGE_HUGE | __XMALLOC_LARGE_SHRUNK)
+
+/**
+ * \brief Large memory chunks of at least this size are mapped directly, so
+ * that reallocations move pages instead of bytes, see \c xReallocHuge() .
+ */
+#define __XMALLOC_HUGE_BLOCK_SIZE                         \
+  (256 * __XMALLOC_SIZEOF_SYSTEM_PAGE)
+
+/**
+ * \brief Index in \c xStaticBin of the bin of blocks of \c size bytes as an
+ * integer constant expression, i.e. the entry of \c xSize2Bin spelled out. It
+ * is meant for sizes known at compile time, \c size must be a small size
+ * > 0.
+ */
+#define __XMALLOC_STATIC_BIN_WORDS(size)                  \
+  ((((size)-1) >> __XMALLOC_LOG_SIZEOF_ALIGNMENT) + 1)
+#define __XMALLOC_STATIC_BIN_INDEX(size)                  \
+  (__XMALLOC_STATIC_BIN_WORDS(size) <= 10 ?               \
+    __XMALLOC_STATIC_BIN_WORDS(size) - 1 :                \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 12  ? 10 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 14  ? 11 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 16  ? 12 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 18  ? 13 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 20  ? 14 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 24  ? 15 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 28  ? 16 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 38  ? 17 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 50  ? 18 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 63  ? 19 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 84  ? 20 :         \
+   __XMALLOC_STATIC_BIN_WORDS(size) <= 101 ? 21 : 22)
+
+/**
+ * \brief Bin of blocks of \c size bytes resolved at compile time if \c size
+ * is a constant, there is no load from \c xSize2Bin .
+ */
+#define xConstSize2Bin(size)                              \
+  (&xStaticBin[__XMALLOC_STATIC_BIN_INDEX(size)])
+
+/**
+ * \brief True if \c size is known to the compiler and fits into a bin.
+ */
+#define xIsSmallConstSize(size)                           \
+  (__builtin_constant_p(size) && (size) > 0 &&            \
+   (size) <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+
 /****************************************************
  * DEBUG STUFF:
  * predeclarations, for implementations see bottom
@@ -94,7 +176,32 @@ static inline size_t xSizeOfBinAddr(const void *addr)
  */
 static inline size_t xSizeOfLargeAddr(const void *addr)
 {
-  return *((long *) ((char *) addr - __XMALLOC_SIZEOF_ALIGNMENT));
+  // blocks of spans behind their first page are no bin addresses
+  if (xIsSpanAddr(addr))
+    return (xGetTopBinOfPage(xGetPageOfSpanAddr(addr))->sizeInWords <<
+            __XMALLOC_LOG_SIZEOF_ALIGNMENT);
+  return *((size_t *) ((char *) addr - __XMALLOC_SIZEOF_ALIGNMENT)) &
+          ~__XMALLOC_LARGE_FLAGS;
+}
+
+/**
+ * \fn static inline size_t xAllocatedSizeOfLargeAddr(const void *addr)
+ *
+ * \brief Get the number of bytes allocated from the system for the ordinary
+ * large memory chunk at address \c addr , not counting the size in front of
+ * it. This differs from \c xSizeOfLargeAddr() only for chunks marked by
+ * __XMALLOC_LARGE_SHRUNK.
+ *
+ * \param addr Const pointer to the corresponding address.
+ *
+ * \return allocated size of address \c addr
+ */
+static inline size_t xAllocatedSizeOfLargeAddr(const void *addr)
+{
+  size_t size = *((size_t *) ((char *) addr - __XMALLOC_SIZEOF_ALIGNMENT));
+  if (size & __XMALLOC_LARGE_SHRUNK)
+    return *((size_t *) ((char *) addr + (size & ~__XMALLOC_LARGE_FLAGS)));
+  return size;
 }
 
 /**
@@ -114,6 +221,74 @@ static inline size_t xSizeOfAddr(const void *addr)
 /*********************************************************
  * GENERAL MALLOC AND FREE STUFF
  ********************************************************/
+/**
+ * \fn void* xMallocAlignedLarge(const size_t size, const size_t alignment)
+ *
+ * \brief Allocates a large memory chunk of \c size bytes aligned to
+ * \c alignment from the system. Besides the size, which is marked by
+ * __XMALLOC_LARGE_ALIGNED, the offset to the address returned by the system
+ * is stored in front of the chunk.
+ *
+ * \param size size of the memory chunk
+ *
+ * \param alignment power of 2 the address is a multiple of
+ *
+ * \return address of memory allocated
+ *
+ */
+void* xMallocAlignedLarge(const size_t size, const size_t alignment);
+
+/**
+ * \fn void* xMallocHuge(const size_t size)
+ *
+ * \brief Allocates a huge memory chunk of \c size bytes directly from the
+ * system via \c __XMALLOC_VALLOC . The size, marked by __XMALLOC_LARGE_HUGE,
+ * and the length of the mapping are stored in front of the chunk.
+ *
+ * \param size size of the memory chunk, at least __XMALLOC_HUGE_BLOCK_SIZE
+ *
+ * \return address of memory allocated, initialized to zero
+ *
+ */
+void* xMallocHuge(const size_t size);
+
+/**
+ * \fn void* xReallocHuge(void *addr, const size_t newSize)
+ *
+ * \brief Resizes a huge memory chunk, the pages of the mapping are moved by
+ * \c xVreallocFromSystem() instead of copying the contents. If the mapping
+ * cannot be resized the contents are copied to an ordinary large chunk from
+ * \c xAllocFromSystem() .
+ *
+ * \param addr address of a chunk of \c xMallocHuge()
+ *
+ * \param newSize new size of the memory chunk
+ *
+ * \return address of the resized memory chunk
+ *
+ */
+void* xReallocHuge(void *addr, const size_t newSize);
+
+/**
+ * \fn void xFreeHuge(void *addr)
+ *
+ * \brief Frees a memory chunk allocated by \c xMallocHuge() .
+ *
+ * \param addr address of memory to be deleted.
+ *
+ */
+void xFreeHuge(void *addr);
+
+/**
+ * \fn void xFreeAlignedLarge(void *addr)
+ *
+ * \brief Frees a memory chunk allocated by \c xMallocAlignedLarge() .
+ *
+ * \param addr address of memory to be deleted.
+ *
+ */
+void xFreeAlignedLarge(void *addr);
+
 /**
  * \fn static inline void* xMalloc(const size_t size)
  *
@@ -133,17 +308,59 @@ static inline void* xMalloc(const size_t size)
   {
     xBin bin  = xSmallSize2Bin(size);
     addr      = xAllocFromBin(bin);
+    __XMALLOC_RECORD_MALLOC(addr, size);
+    return addr;
+  }
+  else if (size >= __XMALLOC_HUGE_BLOCK_SIZE)
+  {
+    addr  = xMallocHuge(size);
+    __XMALLOC_RECORD_MALLOC(addr, size);
     return addr;
   }
   else
   {
-    long *ptr  = (long*) malloc(size + __XMALLOC_SIZEOF_ALIGNMENT);
+    __XMALLOC_LATENCY_START(start);
+    long *ptr  = (long*) __XMALLOC_SYSTEM_MALLOC(size +
+                    __XMALLOC_SIZEOF_ALIGNMENT);
+    __XMALLOC_LATENCY_STOP(xLatency_LargeSystem, start);
     *ptr       = size;
     char *pptr= (char*) ptr;
+    __XMALLOC_TRACE_EVENT(xTrace_LargeMalloc,
+        pptr + __XMALLOC_SIZEOF_ALIGNMENT, size);
+    __XMALLOC_PROBE2(large__alloc, pptr + __XMALLOC_SIZEOF_ALIGNMENT, size);
+    __XMALLOC_RECORD_MALLOC(pptr + __XMALLOC_SIZEOF_ALIGNMENT, size);
     return (void*)(pptr + __XMALLOC_SIZEOF_ALIGNMENT);
   }
 }
 
+/**
+ * \fn static inline void* xMallocNear(const void *hint, const size_t size)
+ *
+ * \brief As \c xMalloc() , a small block is placed on the page of \c hint
+ * if this page has free blocks of the size class of \c size , see
+ * \c xAllocBinNear() .
+ *
+ * \param hint address of a block allocated by xmalloc, or NULL
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \return address of memory allocated
+ *
+ * \note It is assumed that \c size > 0.
+ *
+ */
+static inline void* xMallocNear(const void *hint, const size_t size)
+{
+  void *addr;
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+  {
+    addr  = xAllocFromBinNear(xSmallSize2Bin(size), hint);
+    __XMALLOC_RECORD_MALLOC(addr, size);
+    return addr;
+  }
+  return xMalloc(size);
+}
+
 /**
  * \fn static inline void* xMalloc0(const size_t size)
  *
@@ -162,22 +379,271 @@ static inline void* xMalloc0(size_t size)
   void *addr  = NULL;
   if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
   {
-    xBin bin  = xSmallSize2Bin(size);
-    addr      = xAllocFromBin(bin);
-    memset(addr, 0, bin->sizeInWords * __XMALLOC_SIZEOF_ALIGNMENT);
+    addr  = xAlloc0FromBin(xSmallSize2Bin(size));
+    __XMALLOC_RECORD_MALLOC(addr, size);
+    return addr;
+  }
+  else if (size >= __XMALLOC_HUGE_BLOCK_SIZE)
+  {
+    // fresh pages of the system are zero already
+    addr  = xMallocHuge(size);
+    __XMALLOC_RECORD_MALLOC(addr, size);
     return addr;
   }
   else
   {
-    long *ptr  = (long*) malloc(size + __XMALLOC_SIZEOF_ALIGNMENT);
+    // accounted as xFreeLargeAddr() gives it back by xFreeSizeToSystem()
+    __XMALLOC_LATENCY_START(start);
+    long *ptr  = (long*) xAlloc0FromSystem(size +
+                    __XMALLOC_SIZEOF_ALIGNMENT);
+    __XMALLOC_LATENCY_STOP(xLatency_LargeSystem, start);
     *ptr       = size;
     char *pptr= (char*) ptr;
     pptr += __XMALLOC_SIZEOF_ALIGNMENT;
-    memset(pptr, 0, size);
+    __XMALLOC_TRACE_EVENT(xTrace_LargeMalloc, pptr, size);
+    __XMALLOC_PROBE2(large__alloc, pptr, size);
+    __XMALLOC_RECORD_MALLOC(pptr, size);
     return (void*)pptr;
   }
 }
 
+/**
+ * \fn static inline void* xMallocSmallBin(xBin bin, const size_t size)
+ *
+ * \brief Allocates memory of size class \c size from \c bin , which is the
+ * bin of \c size . This is the small block path of \c xMalloc() without the
+ * size check and the lookup of the bin.
+ *
+ * \param bin \c xBin of \c size
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xMallocSmallBin(xBin bin, const size_t size)
+{
+  void *addr  = xAllocFromBin(bin);
+  __XMALLOC_RECORD_MALLOC(addr, size);
+  return addr;
+}
+
+/**
+ * \fn static inline void* xMalloc0SmallBin(xBin bin, const size_t size)
+ *
+ * \brief Allocates memory of size class \c size from \c bin , which is the
+ * bin of \c size , and initializes \c size bytes to zero.
+ *
+ * \param bin \c xBin of \c size
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xMalloc0SmallBin(xBin bin, const size_t size)
+{
+  void *addr  = xAlloc0SizeFromBin(bin, size);
+  __XMALLOC_RECORD_MALLOC(addr, size);
+  return addr;
+}
+
+/**
+ * \fn xBin xGetAlignedBin(size_t size, size_t alignment)
+ *
+ * \brief Gets the bin of blocks of \c size bytes rounded up to
+ * \c alignment and creates it if needed. This is a static bin if there is one
+ * of exactly this block size, otherwise a bin with pages whose first block
+ * starts at \c alignment .
+ *
+ * \param size size of the blocks, at most __XMALLOC_MAX_SMALL_BLOCK_SIZE
+ *
+ * \param alignment power of 2 from 32 up to __XMALLOC_MAX_BIN_ALIGNMENT
+ *
+ * \return bin of \c size aligned to \c alignment
+ *
+ */
+xBin xGetAlignedBin(size_t size, size_t alignment);
+
+/**
+ * \fn static inline xBin xAlignedSize2Bin(size_t size, size_t alignment)
+ *
+ * \brief Gets a bin of blocks of at least \c size bytes which are all
+ * aligned to \c alignment , see xBlockAlignmentOfSize(). Up to 16 bytes this
+ * is the smallest static bin with a suitable block size, for larger
+ * alignments the bin of \c xGetAlignedBin() .
+ *
+ * \param size size of the blocks
+ *
+ * \param alignment power of 2
+ *
+ * \return bin, NULL if \c size is no small size or \c alignment exceeds
+ * __XMALLOC_MAX_BIN_ALIGNMENT
+ *
+ */
+static inline xBin xAlignedSize2Bin(size_t size, size_t alignment)
+{
+  xBin bin;
+  unsigned long logAlignment;
+  if (0 == size)
+    size  = 1;
+  if (size > __XMALLOC_MAX_SMALL_BLOCK_SIZE ||
+      alignment > __XMALLOC_MAX_BIN_ALIGNMENT)
+    return NULL;
+  if (alignment < 32)
+  {
+    for (bin = xSmallSize2Bin(size);
+         bin <= &xStaticBin[__XMALLOC_MAX_BIN_INDEX]; bin++)
+    {
+      if (xBlockAlignmentOfSize(bin->sizeInWords <<
+            __XMALLOC_LOG_SIZEOF_ALIGNMENT) >= alignment)
+        return bin;
+    }
+  }
+  logAlignment  = __builtin_ctzl(alignment);
+  bin           = xAlignedBin[logAlignment - 5][(size - 1) >> logAlignment];
+  if (NULL != bin)
+    return bin;
+  return xGetAlignedBin(size, alignment);
+}
+
+/**
+ * \fn static inline void* xMallocAligned(const size_t size,
+ *      const size_t alignment)
+ *
+ * \brief Allocates memory of size class \c size aligned to \c alignment .
+ * Small sizes come from a bin keeping the alignment, see
+ * \c xAlignedSize2Bin() , everything else is a large chunk from
+ * \c xMallocAlignedLarge() . The memory is freed by \c xFree() or
+ * \c xFreeSize() .
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \param alignment power of 2, e.g. 16, 32, 64 or the page size
+ *
+ * \return address of memory allocated
+ *
+ * \note For an alignment beyond __XMALLOC_MAX_BIN_ALIGNMENT a small size is
+ * raised to a large one, such a chunk must be freed by \c xFree() or by
+ * \c xFreeSize() with a size larger than __XMALLOC_MAX_SMALL_BLOCK_SIZE.
+ *
+ */
+static inline void* xMallocAligned(const size_t size, const size_t alignment)
+{
+  xBin bin;
+  __XMALLOC_ASSERT(xIsAlignment(alignment));
+  if (alignment <= __XMALLOC_SIZEOF_ALIGNMENT)
+    return xMalloc(size);
+  bin = xAlignedSize2Bin(size, alignment);
+  if (NULL != bin)
+    return xMallocSmallBin(bin, size);
+  return xMallocAlignedLarge((size > __XMALLOC_MAX_SMALL_BLOCK_SIZE ? size :
+                              __XMALLOC_MAX_SMALL_BLOCK_SIZE + 1), alignment);
+}
+
+/**
+ * \fn static inline void* xMalloc0Aligned(const size_t size,
+ *      const size_t alignment)
+ *
+ * \brief As \c xMallocAligned() , the memory is initialized to zero.
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \param alignment power of 2
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xMalloc0Aligned(const size_t size, const size_t alignment)
+{
+  void *addr  = xMallocAligned(size, alignment);
+  memset(addr, 0, size);
+  return addr;
+}
+
+/**
+ * \brief Allocates \c size bytes. For a constant small size the bin is
+ * resolved at compile time and the block is taken directly from it,
+ * otherwise this is \c xMalloc() .
+ */
+#define xMallocConst(size)                                \
+  (xIsSmallConstSize(size) ?                              \
+    xMallocSmallBin(xConstSize2Bin(size), (size)) :       \
+    xMalloc(size))
+
+/**
+ * \brief As \c xMallocConst() , the memory is initialized to zero.
+ */
+#define xMalloc0Const(size)                               \
+  (xIsSmallConstSize(size) ?                              \
+    xMalloc0SmallBin(xConstSize2Bin(size), (size)) :      \
+    xMalloc0(size))
+
+/**
+ * \brief Typed allocation of one object of type \c type , freed by
+ * \c xDelete() .
+ */
+#define xNew(type)          ((type *) xMallocConst(sizeof(type)))
+#define xNew0(type)         ((type *) xMalloc0Const(sizeof(type)))
+#define xDelete(addr)       xFreeSize((addr), sizeof(*(addr)))
+
+/**
+ * \fn static inline void* xAllocBin(xBin bin)
+ *
+ * \brief Allocates a block of \c bin , e.g. a bin returned by
+ * \c xGetSpecBin() . The block is freed by \c xFreeBin() .
+ *
+ * \param bin \c xBin the block is allocated from
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xAllocBin(xBin bin)
+{
+  void *addr  = xAllocFromBin(bin);
+  __XMALLOC_RECORD_ALLOC_BIN(addr, bin);
+  return addr;
+}
+
+/**
+ * \fn static inline void* xAllocBinNear(xBin bin, const void *hint)
+ *
+ * \brief As \c xAllocBin() , the block is placed on the page of \c hint if
+ * it belongs to \c bin and has free blocks, else preferably on a page of the
+ * same region. Allocating the successor of a block of a linked structure
+ * with the block as hint keeps traversals on few pages.
+ *
+ * \param bin \c xBin the block is allocated from
+ *
+ * \param hint address of a block allocated by xmalloc, or NULL
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xAllocBinNear(xBin bin, const void *hint)
+{
+  void *addr  = xAllocFromBinNear(bin, hint);
+  __XMALLOC_RECORD_ALLOC_BIN(addr, bin);
+  return addr;
+}
+
+/**
+ * \fn static inline void* xAlloc0Bin(xBin bin)
+ *
+ * \brief Allocates a block of \c bin and initializes it to zero.
+ *
+ * \param bin \c xBin the block is allocated from
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xAlloc0Bin(xBin bin)
+{
+  void *addr  = xAlloc0FromBin(bin);
+  __XMALLOC_RECORD_ALLOC_BIN(addr, bin);
+  return addr;
+}
+
 /**
  * \fn static inline void* xmalloc(const size_t size)
  *
@@ -206,8 +672,8 @@ static inline void* xmalloc(const size_t size) {
  *
  */
 static inline void xFreeBinAddr(void *addr) {
-  register void *__addr = addr;
-  register xPage __page = (xPage) xGetPageOfAddr(__addr);
+  void *__addr = addr;
+  xPage __page = (xPage) xGetPageOfAddr(__addr);
   xFreeToPage(__page, __addr);
 }
 
@@ -225,8 +691,14 @@ static inline void xFreeBinAddr(void *addr) {
  */
 static inline void xFreeBin(void *addr, xBin bin)
 {
-  register void *__addr = addr;
-  register xPage __page = (xPage) xGetPageOfAddr(__addr);
+  void *__addr = addr;
+  __XMALLOC_RECORD_FREE(addr);
+  xPage __page = (xPage) xGetPageOfAddr(__addr);
+  // only bins of blocks larger than the ones of the static bins have spans
+  if (bin->sizeInWords > (__XMALLOC_MAX_SMALL_BLOCK_SIZE >>
+                          __XMALLOC_LOG_SIZEOF_ALIGNMENT) &&
+      xIsSpanAddr(__addr))
+    __page  = xGetPageOfSpanAddr(__addr);
   xFreeToPage(__page, __addr);
 }
 
@@ -243,7 +715,22 @@ static inline void xFreeBin(void *addr, xBin bin)
 static inline void xFreeLargeAddr(void *addr)
 {
   char *_addr  = (char *)addr - __XMALLOC_SIZEOF_ALIGNMENT;
-  xFreeSizeToSystem(_addr,*((long*) _addr) + __XMALLOC_SIZEOF_ALIGNMENT);
+  // blocks of spans behind their first page are no bin addresses
+  if (xIsSpanAddr(addr))
+  {
+    xFreeToPage(xGetPageOfSpanAddr(addr), addr);
+    return;
+  }
+  if (*((size_t *) _addr) & (__XMALLOC_LARGE_ALIGNED | __XMALLOC_LARGE_HUGE))
+  {
+    if (*((size_t *) _addr) & __XMALLOC_LARGE_HUGE)
+      xFreeHuge(addr);
+    else
+      xFreeAlignedLarge(addr);
+    return;
+  }
+  xFreeSizeToSystem(_addr,
+      xAllocatedSizeOfLargeAddr(addr) + __XMALLOC_SIZEOF_ALIGNMENT);
 }
 
 /**
@@ -258,6 +745,7 @@ static inline void xFreeLargeAddr(void *addr)
  */
 static inline void xFree(void *addr)
 {
+  __XMALLOC_RECORD_FREE(addr);
   if (xIsBinAddr(addr))
     xFreeBinAddr(addr);
   else
@@ -273,14 +761,22 @@ static inline void xFree(void *addr)
  *
  * \param size size of memory to be deleted.
  *
- * \note It is assumed that \c addr != NULL.
+ * \note It is assumed that \c addr != NULL. Chunks of \c xMallocAligned()
+ * with an alignment beyond __XMALLOC_MAX_BIN_ALIGNMENT are freed by
+ * \c xFree() , since their size does not tell that they are large.
  *
  */
 static inline void xFreeSize(void *addr, size_t size) {
   __XMALLOC_ASSERT(NULL != addr);
   __XMALLOC_ASSERT(0 != size);
+  __XMALLOC_RECORD_FREE(addr);
   if ((size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE) || xIsBinAddr(addr))
+  {
+    // a small size of a chunk from xMallocAligned() beyond the bin
+    // alignments does not tell a bin block
+    __XMALLOC_ASSERT(xIsBinAddr(addr));
     xFreeBinAddr(addr);
+  }
   else
     xFreeLargeAddr(addr);
 }
@@ -315,6 +811,113 @@ static inline void xfreeSize(void *addr, size_t size) {
     return xFreeSize(addr, size);
 }
 
+/************************************************
+ * SIZED ALLOCATION WITHOUT HEADERS
+ ***********************************************/
+/**
+ * \fn static inline void* xMallocSized(const size_t size)
+ *
+ * \brief Allocates memory of size class \c size the caller frees by
+ * \c xFreeSized() with the same size. Small sizes come from their bin as in
+ * \c xMalloc() , large chunks come directly from the system without the size
+ * stored in front of them. So they are 8 bytes smaller and freeing them
+ * touches neither the chunk nor the page bitmap.
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \return address of memory allocated
+ *
+ * \note The memory must not be passed to \c xFree() , \c xFreeSize() ,
+ * \c xSizeOfAddr() or the reallocation functions of xmalloc apart from
+ * \c xReallocSized() .
+ *
+ */
+static inline void* xMallocSized(const size_t size)
+{
+  void *addr;
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+    return xMallocSmallBin(xSmallSize2Bin(size), size);
+  // accounted as xFreeSized() gives it back by xFreeSizeToSystem()
+  __XMALLOC_LATENCY_START(start);
+  addr  = xAllocFromSystem(size);
+  __XMALLOC_LATENCY_STOP(xLatency_LargeSystem, start);
+  __XMALLOC_TRACE_EVENT(xTrace_LargeMalloc, addr, size);
+  __XMALLOC_PROBE2(large__alloc, addr, size);
+  __XMALLOC_RECORD_MALLOC(addr, size);
+  return addr;
+}
+
+/**
+ * \fn static inline void* xMalloc0Sized(const size_t size)
+ *
+ * \brief As \c xMallocSized() , the memory is initialized to zero.
+ *
+ * \param size Const \c size_t giving size class.
+ *
+ * \return address of memory allocated
+ *
+ */
+static inline void* xMalloc0Sized(const size_t size)
+{
+  void *addr;
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+    return xMalloc0SmallBin(xSmallSize2Bin(size), size);
+  __XMALLOC_LATENCY_START(start);
+  addr  = xAlloc0FromSystem(size);
+  __XMALLOC_LATENCY_STOP(xLatency_LargeSystem, start);
+  __XMALLOC_TRACE_EVENT(xTrace_LargeMalloc, addr, size);
+  __XMALLOC_PROBE2(large__alloc, addr, size);
+  __XMALLOC_RECORD_MALLOC(addr, size);
+  return addr;
+}
+
+/**
+ * \fn static inline void xFreeSized(void *addr, const size_t size)
+ *
+ * \brief Frees memory allocated by \c xMallocSized() . \c size decides
+ * alone between the bin and the system, neither the page bitmap nor a header
+ * of the chunk is read.
+ *
+ * \param addr address of memory to be deleted.
+ *
+ * \param size size passed to \c xMallocSized()
+ *
+ * \note It is assumed that \c addr != NULL.
+ *
+ */
+static inline void xFreeSized(void *addr, const size_t size)
+{
+  __XMALLOC_ASSERT(NULL != addr);
+  __XMALLOC_ASSERT(0 != size);
+  __XMALLOC_RECORD_FREE(addr);
+  if (size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE)
+  {
+    __XMALLOC_ASSERT(xIsBinAddr(addr));
+    xFreeBinAddr(addr);
+  }
+  else
+  {
+    __XMALLOC_ASSERT(!xIsBinAddr(addr));
+    xFreeSizeToSystem(addr, size);
+  }
+}
+
+/**
+ * \fn void* xReallocSized(void *oldPtr, size_t oldSize, size_t newSize)
+ *
+ * \brief Reallocates memory of \c xMallocSized() to \c newSize bytes, the
+ * result is freed by \c xFreeSized() with \c newSize .
+ *
+ * \param oldPtr address of old memory chunk
+ *
+ * \param oldSize size of old memory chunk
+ *
+ * \param newSize size of new memory chunk
+ *
+ * \return address of new memory chunk
+ */
+void* xReallocSized(void *oldPtr, size_t oldSize, size_t newSize);
+
 void xFreeSizeFunc(void *ptr, size_t size);
 
 xRegion xIsBinBlock(unsigned long region);
@@ -356,7 +959,7 @@ void xUnGetSpecBin(xBin *oldBin, int remove);
 void* xReallocLarge(void *oldPtr, size_t newSize);
 
 /**
- * \fn void* xRealloc0Large(void *oldPtr, size_t newSize)
+ * \fn void* xRealloc0Large(void *oldPtr, size_t oldSize, size_t newSize)
  *
  * \brief Reallocates memory to \c newSize chunk from system and initializes
  * everything to zero. For this it takes care of xmallocs alignment of those
@@ -364,11 +967,14 @@ void* xReallocLarge(void *oldPtr, size_t newSize);
  *
  * \param oldPtr address of old memory chunk
  *
+ * \param oldSize size of old memory chunk known to the caller, everything
+ * behind it is initialized to zero
+ *
  * \param newSize size of new memory chunk
  *
  * \return address of new memory chunk
  */
-void* xRealloc0Large(void *oldPtr, size_t newSize);
+void* xRealloc0Large(void *oldPtr, size_t oldSize, size_t newSize);
 
 /**
  * \fn void* xReallocSize(void *oldPtr, size_t oldSize, size_t newSize)
@@ -573,7 +1179,11 @@ static inline void* xMemDup(void *str)
 {
   size_t oldSize = xSizeOfAddr(str);
   void *newPtr   = xMalloc(oldSize);
-  memcpy(newPtr, str, oldSize);
+  // blocks of bins are whole words
+  if (0 == (oldSize & __XMALLOC_SIZEOF_ALIGNMENT_MINUS_ONE))
+    xCopyBlock(newPtr, str, oldSize >> __XMALLOC_LOG_SIZEOF_ALIGNMENT);
+  else
+    memcpy(newPtr, str, oldSize);
   return newPtr;
 }
 
@@ -593,10 +1203,43 @@ static inline void* xMemDup(void *str)
  */
 xBin xGetStickyBinOfBin(xBin bin);
 
+/**
+ * \fn void xMergeStickyBinIntoBin(xBin sBin, xBin bin)
+ *
+ * \brief Gives all pages of the sticky bin \c sBin to \c bin and frees
+ * \c sBin afterwards. Blocks allocated from \c sBin stay valid, they belong
+ * to \c bin now. Full pages are put in front of the current page of \c bin ,
+ * pages with free blocks behind it, so they are used up next. The pages are
+ * visited once to set their new owner.
+ *
+ * \param sBin \c xBin sticky, gotten by \c xGetStickyBinOfBin(bin)
+ *
+ * \param bin \c xBin \c sBin was gotten from
+ *
+ */
+void xMergeStickyBinIntoBin(xBin sBin, xBin bin);
+
+/**
+ * \fn void xUnGetStickyBinOfBin(xBin *sBin)
+ *
+ * \brief Releases all pages of the sticky bin \c *sBin and frees it. This
+ * frees all blocks allocated from \c *sBin at once, afterwards \c *sBin is
+ * NULL.
+ *
+ * \param sBin pointer to \c xBin sticky, gotten by \c xGetStickyBinOfBin()
+ *
+ * \note No block of \c *sBin must be in use anymore, blocks to be kept are
+ * given to the bin \c *sBin was gotten from by \c xMergeStickyBinIntoBin()
+ * instead.
+ *
+ */
+void xUnGetStickyBinOfBin(xBin *sBin);
+
 
 
-#define xAlloc0Aligned(S)       xMalloc0(S)
-#define xAllocAligned(S)        xMalloc(S)
+// aligned as max_align_t, e.g. for long double and SSE types
+#define xAlloc0Aligned(S)       xMalloc0Aligned((S), 2 * __XMALLOC_SIZEOF_ALIGNMENT)
+#define xAllocAligned(S)        xMallocAligned((S), 2 * __XMALLOC_SIZEOF_ALIGNMENT)
 #define xInitInfo()
 #define xInitGetBackTrace()
 #define xPrintStats(F)
@@ -629,7 +1272,6 @@ xBin xGetStickyBinOfBin(xBin bin);
 #endif
 #define xTestList(A, B)                          xError_NoError
 #define xInitRet_2_Info(argv0)                  ((void) 0)
-#define xMergeStickyBinIntoBin(A, B)            ((void) 0)
 #define xPrintUsedTrackAddrs(A, B)              ((void) 0)
 #define xPrintUsedAddrs(A, B)                   ((void) 0)
 #define xPrintCurrentBackTrace(A)               ((void) 0)
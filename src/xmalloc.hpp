@@ -0,0 +1,385 @@
+/**
+ * \file   xmalloc.hpp
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  C++ interface of xmalloc: \c xm::allocator<T> for the
+ *         containers of the standard library and optionally global
+ *         replacements of operator new and operator delete. The namespace
+ *         is xm since xmalloc() is already a function of xmalloc.h.
+ *         Node based containers as std::list, std::set or std::map allocate
+ *         one node at a time, such single objects come directly from the
+ *         static bin of their size which is chosen at compile time.
+ *         To replace operator new and operator delete by xmalloc define
+ *         XMALLOC_REPLACE_OPERATOR_NEW before including this header in
+ *         exactly one translation unit of the program.
+ *         As xmalloc itself neither the allocator nor the operators are
+ *         thread-safe.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_HPP
+#define XMALLOC_HPP
+
+#include <cstddef>
+#include <new>
+#include "xmalloc.h"
+
+#if __cplusplus >= 201103L
+#define __XMALLOC_NOEXCEPT noexcept
+#else
+#define __XMALLOC_NOEXCEPT throw()
+#endif
+
+namespace xm {
+
+#if __cplusplus >= 201103L
+/**
+ * \fn constexpr std::size_t static_bin_index(std::size_t size)
+ *
+ * \brief Index in \c xStaticBin of the bin of blocks of \c size bytes,
+ * evaluated at compile time for constant sizes.
+ *
+ * \param size size of the blocks, at most __XMALLOC_MAX_SMALL_BLOCK_SIZE
+ *
+ * \return index of the static bin
+ *
+ */
+constexpr std::size_t static_bin_index(std::size_t size)
+{
+  return (0 == size ? 0 : __XMALLOC_STATIC_BIN_INDEX(size));
+}
+#endif
+
+/**
+ * \struct size_class
+ *
+ * \brief Size class of blocks of \c Size bytes, computed at compile time.
+ * \c index is the index of its bin in \c xStaticBin , \c small is false if
+ * blocks of this size are too large for the bins.
+ */
+template <std::size_t Size>
+struct size_class {
+#if __cplusplus >= 201103L
+  static constexpr bool         small = (Size > 0 &&
+                                         Size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  static constexpr std::size_t  index = (small ? static_bin_index(Size) : 0);
+#else
+  static const bool             small = (Size > 0 &&
+                                         Size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  static const std::size_t      index = (small ?
+                                         __XMALLOC_STATIC_BIN_INDEX(Size) : 0);
+#endif
+
+  /**
+   * \fn static xBin bin()
+   *
+   * \brief Gets the static bin of the size class, a constant address.
+   *
+   * \return static bin, NULL if \c small is false
+   *
+   */
+  static xBin bin()
+  {
+    return (small ? &xStaticBin[index] : NULL);
+  }
+};
+
+/**
+ * \fn template <class T> T* alloc()
+ *
+ * \brief Typed allocation of uninitialized memory for one object of type
+ * \c T , the bin is resolved at compile time. It is freed by \c free() .
+ *
+ * \return address of the memory allocated
+ *
+ */
+template <class T>
+inline T* alloc()
+{
+  if (size_class<sizeof(T)>::small)
+    return static_cast<T*>(xMallocSmallBin(size_class<sizeof(T)>::bin(),
+                                           sizeof(T)));
+  return static_cast<T*>(xMalloc(sizeof(T)));
+}
+
+/**
+ * \fn template <class T> T* alloc0()
+ *
+ * \brief As \c alloc() , the memory is initialized to zero.
+ *
+ * \return address of the memory allocated
+ *
+ */
+template <class T>
+inline T* alloc0()
+{
+  if (size_class<sizeof(T)>::small)
+    return static_cast<T*>(xMalloc0SmallBin(size_class<sizeof(T)>::bin(),
+                                            sizeof(T)));
+  return static_cast<T*>(xMalloc0(sizeof(T)));
+}
+
+/**
+ * \fn template <class T> void free(T *addr)
+ *
+ * \brief Frees memory allocated by \c alloc() or \c alloc0() .
+ *
+ * \param addr address of the memory, not NULL
+ *
+ */
+template <class T>
+inline void free(T *addr)
+{
+  // the constant size lets xFreeSize() go directly to the bin
+  xFreeSize(addr, sizeof(T));
+}
+
+/**
+ * \class allocator
+ *
+ * \brief Allocator satisfying the Allocator requirements of the standard
+ * library. Single objects, i.e. \c n == 1, of at most
+ * __XMALLOC_MAX_SMALL_BLOCK_SIZE bytes are allocated from their static bin
+ * without any size computation at runtime. As \c deallocate() always gets
+ * the size everything else is allocated by \c xMallocSized() , large arrays
+ * carry no header.
+ */
+template <class T>
+class allocator {
+public:
+  typedef T                 value_type;
+  typedef T*                pointer;
+  typedef const T*          const_pointer;
+  typedef T&                reference;
+  typedef const T&          const_reference;
+  typedef std::size_t       size_type;
+  typedef std::ptrdiff_t    difference_type;
+
+  template <class U>
+  struct rebind {
+    typedef allocator<U> other;
+  };
+
+  allocator() __XMALLOC_NOEXCEPT {}
+
+  allocator(const allocator&) __XMALLOC_NOEXCEPT {}
+
+  template <class U>
+  allocator(const allocator<U>&) __XMALLOC_NOEXCEPT {}
+
+  pointer address(reference x) const
+  {
+    return &x;
+  }
+
+  const_pointer address(const_reference x) const
+  {
+    return &x;
+  }
+
+  /**
+   * \fn pointer allocate(size_type n, const void *hint = 0)
+   *
+   * \brief Allocates memory for \c n objects of type \c T .
+   *
+   * \param n number of objects
+   *
+   * \return address of the memory allocated
+   *
+   * \note Throws \c std::bad_alloc if \c n exceeds \c max_size() or no memory
+   * is available.
+   *
+   */
+  pointer allocate(size_type n, const void * = 0)
+  {
+    void *addr;
+    if (1 == n && size_class<sizeof(T)>::small)
+      return static_cast<pointer>(xAllocBin(size_class<sizeof(T)>::bin()));
+    if (n > max_size())
+      throw std::bad_alloc();
+    addr  = xMallocSized(0 == n ? 1 : n * sizeof(T));
+    if (NULL == addr)
+      throw std::bad_alloc();
+    return static_cast<pointer>(addr);
+  }
+
+  /**
+   * \fn void deallocate(pointer addr, size_type n)
+   *
+   * \brief Frees memory of \c n objects allocated by \c allocate() .
+   *
+   * \param addr address of the memory
+   *
+   * \param n number of objects passed to \c allocate()
+   *
+   */
+  void deallocate(pointer addr, size_type n)
+  {
+    if (1 == n && size_class<sizeof(T)>::small)
+      xFreeBin(addr, size_class<sizeof(T)>::bin());
+    else
+      xFreeSized(addr, 0 == n ? 1 : n * sizeof(T));
+  }
+
+  size_type max_size() const __XMALLOC_NOEXCEPT
+  {
+    return static_cast<size_type>(-1) / sizeof(T);
+  }
+
+#if __cplusplus < 201103L
+  void construct(pointer addr, const_reference value)
+  {
+    new (static_cast<void*>(addr)) T(value);
+  }
+
+  void destroy(pointer addr)
+  {
+    addr->~T();
+  }
+#endif
+};
+
+/**
+ * \class allocator<void>
+ *
+ * \brief Specialization for \c void , needed for rebinding only.
+ */
+template <>
+class allocator<void> {
+public:
+  typedef void        value_type;
+  typedef void*       pointer;
+  typedef const void* const_pointer;
+
+  template <class U>
+  struct rebind {
+    typedef allocator<U> other;
+  };
+};
+
+/* all instances are interchangeable, there is only one xmalloc */
+template <class T, class U>
+inline bool operator==(const allocator<T>&, const allocator<U>&)
+{
+  return true;
+}
+
+template <class T, class U>
+inline bool operator!=(const allocator<T>&, const allocator<U>&)
+{
+  return false;
+}
+
+} // namespace xm
+
+/************************************************
+ * REPLACEMENT OF OPERATOR NEW AND DELETE
+ ***********************************************/
+#ifdef XMALLOC_REPLACE_OPERATOR_NEW
+static inline void* xOperatorNew(std::size_t size)
+{
+  void *addr  = xMalloc(0 == size ? 1 : size);
+  if (NULL == addr)
+    throw std::bad_alloc();
+  return addr;
+}
+
+void* operator new(std::size_t size)
+{
+  return xOperatorNew(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return xOperatorNew(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) __XMALLOC_NOEXCEPT
+{
+  return xMalloc(0 == size ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) __XMALLOC_NOEXCEPT
+{
+  return xMalloc(0 == size ? 1 : size);
+}
+
+void operator delete(void *addr) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+void operator delete[](void *addr) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+void operator delete(void *addr, const std::nothrow_t&) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+void operator delete[](void *addr, const std::nothrow_t&) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+#if __cpp_sized_deallocation >= 201309L
+/* the size is the one passed to operator new, no lookup of the page is
+ * needed to tell small from large blocks */
+void operator delete(void *addr, std::size_t size) __XMALLOC_NOEXCEPT
+{
+  if (NULL != addr)
+    xFreeSize(addr, 0 == size ? 1 : size);
+}
+
+void operator delete[](void *addr, std::size_t size) __XMALLOC_NOEXCEPT
+{
+  if (NULL != addr)
+    xFreeSize(addr, 0 == size ? 1 : size);
+}
+#endif
+
+#if __cpp_aligned_new >= 201606L
+/* over-aligned types, freed by xfree() since chunks with an alignment beyond
+ * the bins are larger than their size */
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  void *addr  = xMallocAligned(0 == size ? 1 : size,
+                               static_cast<std::size_t>(alignment));
+  if (NULL == addr)
+    throw std::bad_alloc();
+  return addr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void operator delete(void *addr, std::align_val_t) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+void operator delete[](void *addr, std::align_val_t) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+void operator delete(void *addr, std::size_t,
+                     std::align_val_t) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+
+void operator delete[](void *addr, std::size_t,
+                       std::align_val_t) __XMALLOC_NOEXCEPT
+{
+  xfree(addr);
+}
+#endif
+#endif
+
+#endif
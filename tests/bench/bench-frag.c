@@ -0,0 +1,280 @@
+/**
+ * \file   bench-frag.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Long running fragmentation benchmark. Each cycle consists of four
+ *         phases:
+ *           grow      allocate small blocks up to the target of live bytes
+ *           free      free a random part of the live blocks
+ *           shift     change the size distribution to medium and large
+ *                     blocks: allocate up to the target again while freeing
+ *                     random old blocks
+ *           shrink    free everything in random order
+ *         Live bytes, RSS from /proc/self/statm, the bytes mapped by xmalloc
+ *         for its regions together with the number of used pages and
+ *         regions are sampled over time and printed as CSV:
+ *           malloc,cycle,phase,seconds,live_kb,rss_kb,mapped_kb,used_pages,
+ *           regions
+ *         This shows how well freed pages and regions are given back, see
+ *         xFreeToPageFault() and xFreePagesFromRegion(). The region walk
+ *         does not need the statistics of the debug library. Mapped bytes
+ *         and pages are empty for the system malloc, for xmalloc they do not
+ *         contain large blocks, which are taken from the system malloc.
+ *         Usage: bench-frag [-x|-s] [-c <cycles>] [-m <target MB>]
+ *                           [-i <ops per sample>]
+ *         A few hundred cycles run for minutes, e.g.
+ *           bench-frag -c 500 -i 1000000 > frag.csv
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+#include "bench.h"
+
+/* percentage of live blocks freed in the free phase */
+#define FREE_PERCENTAGE   75
+/* one out of LARGE_RATIO blocks of the shift phase is a large block */
+#define LARGE_RATIO       64
+
+enum fragPhase_e {
+  fragPhase_Grow = 0,
+  fragPhase_Free,
+  fragPhase_Shift,
+  fragPhase_Shrink,
+  fragPhase_Max
+};
+
+static const char *fragPhaseName[fragPhase_Max] = {
+  "grow",
+  "free",
+  "shift",
+  "shrink"
+};
+
+struct blockStruct {
+  void    *addr;
+  size_t  size;
+};
+
+static int useSystem              = 0;
+static struct blockStruct *blocks = NULL;
+static long numberBlocks          = 0;
+static long maxBlocks             = 0;
+static long live                  = 0;
+static long ops                   = 0;
+static long sampleInterval        = 1L << 16;
+static double start               = 0.0;
+static unsigned int seed          = 1;
+
+static inline unsigned int fragRandom()
+{
+  seed  = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static void fragSample(int cycle, int phase)
+{
+  long pages = 0, usedPages = 0, regions = 0;
+  xRegion region  = xBaseRegion;
+
+  printf("%s,%d,%s,%.3f,%ld,%ld,", (useSystem ? "system" : "xmalloc"), cycle,
+      fragPhaseName[phase], xBenchSeconds() - start, live / 1024,
+      xBenchResidentBytes() / 1024);
+  if (useSystem)
+  {
+    printf(",,\n");
+    return;
+  }
+  // xBaseRegion is somewhere in the middle of the list of regions
+  while (NULL != region && NULL != region->prev)
+    region  = region->prev;
+  for (; NULL != region; region = region->next)
+  {
+    pages     +=  region->totalNumberPages;
+    usedPages +=  region->numberUsedPages;
+    regions++;
+  }
+  printf("%ld,%ld,%ld\n", pages * __XMALLOC_SIZEOF_SYSTEM_PAGE / 1024,
+      usedPages, regions);
+}
+
+static inline void fragOp(int cycle, int phase)
+{
+  if (0 == ++ops % sampleInterval)
+    fragSample(cycle, phase);
+}
+
+static inline void fragAlloc(size_t size)
+{
+  struct blockStruct *block;
+  if (numberBlocks == maxBlocks)
+  {
+    maxBlocks = (0 == maxBlocks ? 65536 : 2 * maxBlocks);
+    blocks    = realloc(blocks, maxBlocks * sizeof(struct blockStruct));
+  }
+  block       = &blocks[numberBlocks++];
+  block->addr = (useSystem ? malloc(size) : xMalloc(size));
+  block->size = size;
+  // the application touches its memory
+  memset(block->addr, 0x5a, size);
+  live  +=  size;
+}
+
+/* frees a random live block, the last one takes its place */
+static inline void fragFree()
+{
+  long i  = fragRandom() % numberBlocks;
+  if (useSystem)
+    free(blocks[i].addr);
+  else
+    xFreeSize(blocks[i].addr, blocks[i].size);
+  live      -=  blocks[i].size;
+  blocks[i] =   blocks[--numberBlocks];
+}
+
+/* frees a random one of the first n live blocks, which are the blocks of
+ * the previous size distribution */
+static inline void fragFreeOld(long n)
+{
+  long i  = fragRandom() % n;
+  if (useSystem)
+    free(blocks[i].addr);
+  else
+    xFreeSize(blocks[i].addr, blocks[i].size);
+  live            -=  blocks[i].size;
+  blocks[i]       =   blocks[n - 1];
+  blocks[n - 1]   =   blocks[--numberBlocks];
+}
+
+static inline size_t fragSmallSize()
+{
+  return 8 + fragRandom() % 249;
+}
+
+static inline size_t fragShiftedSize()
+{
+  if (0 == fragRandom() % LARGE_RATIO)
+    return __XMALLOC_MAX_SMALL_BLOCK_SIZE + 1 + fragRandom() % 16384;
+  return 256 + fragRandom() % (__XMALLOC_MAX_SMALL_BLOCK_SIZE - 255);
+}
+
+static void benchFrag(int cycles, long target)
+{
+  long n;
+  int c;
+
+  printf("%s,0,start,0.000,0,%ld,", (useSystem ? "system" : "xmalloc"),
+      xBenchResidentBytes() / 1024);
+  printf(useSystem ? ",,\n" : "0,0,0\n");
+  start = xBenchSeconds();
+  for (c = 1; c <= cycles; c++)
+  {
+    while (live < target)
+    {
+      fragAlloc(fragSmallSize());
+      fragOp(c, fragPhase_Grow);
+    }
+    fragSample(c, fragPhase_Grow);
+
+    for (n = numberBlocks * FREE_PERCENTAGE / 100; n > 0; n--)
+    {
+      fragFree();
+      fragOp(c, fragPhase_Free);
+    }
+    fragSample(c, fragPhase_Free);
+
+    // free an old block for each new one until the old ones are gone
+    n = numberBlocks;
+    while (live < target || n > 0)
+    {
+      if (live < target)
+      {
+        fragAlloc(fragShiftedSize());
+        fragOp(c, fragPhase_Shift);
+      }
+      if (n > 0)
+      {
+        fragFreeOld(n--);
+        fragOp(c, fragPhase_Shift);
+      }
+    }
+    fragSample(c, fragPhase_Shift);
+
+    while (numberBlocks > 0)
+    {
+      fragFree();
+      fragOp(c, fragPhase_Shrink);
+    }
+    fragSample(c, fragPhase_Shrink);
+    fflush(stdout);
+  }
+  free(blocks);
+}
+
+int main(int argc, char *argv[])
+{
+  int allocators[2] = { 1, 1 };
+  int cycles = 3, opt, s, status;
+  long target = 64;
+  pid_t pid;
+
+  while (-1 != (opt = getopt(argc, argv, "xsc:m:i:")))
+  {
+    switch (opt)
+    {
+      case 'x':
+        allocators[1]   = 0;
+        break;
+      case 's':
+        allocators[0]   = 0;
+        break;
+      case 'c':
+        cycles          = atoi(optarg);
+        break;
+      case 'm':
+        target          = atol(optarg);
+        break;
+      case 'i':
+        sampleInterval  = atol(optarg);
+        break;
+      default:
+        cycles  = 0;
+        break;
+    }
+  }
+  if (optind != argc || cycles < 1 || target < 1 || sampleInterval < 1)
+  {
+    fprintf(stderr, "usage: %s [-x|-s] [-c <cycles>] [-m <target MB>] "
+        "[-i <ops per sample>]\n", argv[0]);
+    return 1;
+  }
+
+  printf("malloc,cycle,phase,seconds,live_kb,rss_kb,mapped_kb,used_pages,"
+      "regions\n");
+  fflush(stdout);
+  for (s = 0; s < 2; s++)
+  {
+    if (!allocators[s])
+      continue;
+    pid = fork();
+    if (0 == pid)
+    {
+      useSystem = s;
+      benchFrag(cycles, target << 20);
+      _exit(0);
+    }
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || 0 != WEXITSTATUS(status))
+    {
+      fprintf(stderr, "bench-frag failed\n");
+      return 1;
+    }
+  }
+  return 0;
+}
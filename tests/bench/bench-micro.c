@@ -0,0 +1,284 @@
+/**
+ * \file   bench-micro.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Isolated microbenchmarks of the fast and slow paths of xmalloc.
+ *         An operation is one allocation together with its deallocation
+ *         unless stated otherwise.
+ *         Usage: bench-micro [-w <warmup>] [-r <repetitions>] [-s|-S] [-p]
+ *                            [filter]
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+#include "bench.h"
+
+#define NUMBER_OPS    (1L << 20)
+#define BATCH         1024
+
+static void *addrs[BATCH];
+
+/************************************************
+ * SMALL BLOCKS
+ ***********************************************/
+static void benchMallocFree(long numberOps, size_t size, int system)
+{
+  long i, j;
+  if (system)
+  {
+    for (i = 0; i < numberOps; i += BATCH)
+    {
+      for (j = 0; j < BATCH; j++)
+        xBenchEscape(addrs[j] = malloc(size));
+      for (j = 0; j < BATCH; j++)
+        free(addrs[j]);
+    }
+  }
+  else
+  {
+    for (i = 0; i < numberOps; i += BATCH)
+    {
+      for (j = 0; j < BATCH; j++)
+        xBenchEscape(addrs[j] = xMalloc(size));
+      for (j = 0; j < BATCH; j++)
+        xFree(addrs[j]);
+    }
+  }
+}
+
+static void benchMalloc0Free(long numberOps, size_t size, int system)
+{
+  long i, j;
+  if (system)
+  {
+    for (i = 0; i < numberOps; i += BATCH)
+    {
+      for (j = 0; j < BATCH; j++)
+        xBenchEscape(addrs[j] = calloc(1, size));
+      for (j = 0; j < BATCH; j++)
+        free(addrs[j]);
+    }
+  }
+  else
+  {
+    for (i = 0; i < numberOps; i += BATCH)
+    {
+      for (j = 0; j < BATCH; j++)
+        xBenchEscape(addrs[j] = xMalloc0(size));
+      for (j = 0; j < BATCH; j++)
+        xFree(addrs[j]);
+    }
+  }
+}
+
+/* one operation is one xAllocBin / xFreeBin pair */
+static void benchAllocBinFreeBin(long numberOps, size_t size, int system)
+{
+  long i, j;
+  xBin bin;
+  if (system)
+  {
+    benchMallocFree(numberOps, size, system);
+    return;
+  }
+  bin = xGetSpecBin(size);
+  for (i = 0; i < numberOps; i += BATCH)
+  {
+    for (j = 0; j < BATCH; j++)
+      xBenchEscape(addrs[j] = xAllocBin(bin));
+    for (j = 0; j < BATCH; j++)
+      xFreeBin(addrs[j], bin);
+  }
+  xUnGetSpecBin(&bin, 0);
+}
+
+/* one operation is one reallocation to the next bigger static bin */
+static void benchReallocSize(long numberOps, size_t size, int system)
+{
+  long i = 0, j;
+  size_t oldSize, newSize;
+  while (i < numberOps)
+  {
+    for (j = 0; j < BATCH; j++)
+      addrs[j]  = (system ? malloc(size) : xMalloc(size));
+    for (oldSize = size; oldSize < __XMALLOC_MAX_SMALL_BLOCK_SIZE;
+         oldSize = newSize)
+    {
+      newSize = __XMALLOC_MIN(2 * oldSize, __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+      for (j = 0; j < BATCH; j++)
+        xBenchEscape(addrs[j] = (system ? realloc(addrs[j], newSize) :
+              xReallocSize(addrs[j], oldSize, newSize)));
+      i +=  BATCH;
+    }
+    for (j = 0; j < BATCH; j++)
+    {
+      if (system)
+        free(addrs[j]);
+      else
+        xFree(addrs[j]);
+    }
+  }
+}
+
+/************************************************
+ * COPYING
+ ***********************************************/
+/* one operation is one copy of a block of size bytes by xCopyBlock() resp.
+ * memcpy(), as done by xReallocSize() and xMemDup() */
+static void benchCopyBlock(long numberOps, size_t size, int system)
+{
+  static long src[__XMALLOC_SIZEOF_SYSTEM_PAGE / sizeof(long)];
+  static long dst[__XMALLOC_SIZEOF_SYSTEM_PAGE / sizeof(long)];
+  size_t words  = size >> __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+  long i;
+  for (i = 0; i < numberOps; i++)
+  {
+    xBenchEscape(src);
+    if (system)
+      memcpy(dst, src, size);
+    else
+      xCopyBlock(dst, src, words);
+    xBenchEscape(dst);
+  }
+}
+
+/************************************************
+ * LARGE BLOCKS
+ ***********************************************/
+static void benchLargeMallocFree(long numberOps, size_t size, int system)
+{
+  long i;
+  int j;
+  if (system)
+  {
+    for (i = 0; i < numberOps; i += 16)
+    {
+      for (j = 0; j < 16; j++)
+        xBenchEscape(addrs[j] = malloc(size));
+      for (j = 0; j < 16; j++)
+        free(addrs[j]);
+    }
+  }
+  else
+  {
+    for (i = 0; i < numberOps; i += 16)
+    {
+      for (j = 0; j < 16; j++)
+        xBenchEscape(addrs[j] = xMalloc(size));
+      for (j = 0; j < 16; j++)
+        xFree(addrs[j]);
+    }
+  }
+}
+
+/************************************************
+ * SLOW PATHS
+ ***********************************************/
+/* one operation is one allocation touching the block, a new page is needed
+ * every (blocks per page) allocations; everything is freed at the end */
+static void benchFirstTouch(long numberOps, size_t size, int system)
+{
+  void **blocks = malloc(numberOps * sizeof(void*));
+  long i;
+  for (i = 0; i < numberOps; i++)
+  {
+    blocks[i] = (system ? malloc(size) : xMalloc(size));
+    *(long *) blocks[i] = i;
+  }
+  for (i = 0; i < numberOps; i++)
+  {
+    if (system)
+      free(blocks[i]);
+    else
+      xFree(blocks[i]);
+  }
+  free(blocks);
+}
+
+/* one operation is one xIsBinAddr() query, half of them on large blocks */
+static void benchIsBinAddr(long numberOps, size_t size, int system)
+{
+  void *bin[64], *large[64];
+  long i, count = 0;
+  int j;
+  for (j = 0; j < 64; j++)
+  {
+    bin[j]    = xMalloc(size);
+    large[j]  = xMalloc(size + __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  }
+  for (i = 0; i < numberOps; i += 128)
+  {
+    for (j = 0; j < 64; j++)
+    {
+      xBenchEscape(bin[j]);
+      count +=  xIsBinAddr(bin[j]);
+      xBenchEscape(large[j]);
+      count +=  xIsBinAddr(large[j]);
+    }
+  }
+  if (count != numberOps / 2)
+    fprintf(stderr, "xIsBinAddr() failed\n");
+  for (j = 0; j < 64; j++)
+  {
+    xFree(bin[j]);
+    xFree(large[j]);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  static const size_t specSizes[] = { 40, 72, 136, 264, 360, 520 };
+  static const size_t largeSizes[] = { 2048, 16384, 131072 };
+  static const size_t copySizes[] = { 16, 64, 128, 224, 504, 1008 };
+  xBenchOpts opts;
+  char name[64];
+  int i;
+
+  if (0 != xBenchParseOpts(&opts, argc, argv))
+  {
+    fprintf(stderr, "usage: %s [-w <warmup>] [-r <repetitions>] [-s|-S] "
+        "[-p] [filter]\n", argv[0]);
+    return 1;
+  }
+  xBenchPrintHeader(&opts);
+  for (i = 0; i < __XMALLOC_MAX_BIN_INDEX + 1; i++)
+  {
+    size_t size = xStaticBin[i].sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+    sprintf(name, "malloc-free/%lu", (unsigned long) size);
+    xBenchRun(&opts, name, benchMallocFree, NUMBER_OPS, size, 1);
+  }
+  for (i = 0; i < sizeof(specSizes) / sizeof(specSizes[0]); i++)
+  {
+    sprintf(name, "allocbin-freebin/%lu", (unsigned long) specSizes[i]);
+    xBenchRun(&opts, name, benchAllocBinFreeBin, NUMBER_OPS, specSizes[i], 1);
+  }
+  sprintf(name, "malloc0-free/64");
+  xBenchRun(&opts, name, benchMalloc0Free, NUMBER_OPS, 64, 1);
+  sprintf(name, "malloc0-free/504");
+  xBenchRun(&opts, name, benchMalloc0Free, NUMBER_OPS, 504, 1);
+  sprintf(name, "realloc-size/8..1008");
+  xBenchRun(&opts, name, benchReallocSize, NUMBER_OPS, 8, 1);
+  for (i = 0; i < sizeof(copySizes) / sizeof(copySizes[0]); i++)
+  {
+    sprintf(name, "copy-block/%lu", (unsigned long) copySizes[i]);
+    xBenchRun(&opts, name, benchCopyBlock, NUMBER_OPS, copySizes[i], 1);
+  }
+  for (i = 0; i < sizeof(largeSizes) / sizeof(largeSizes[0]); i++)
+  {
+    sprintf(name, "large-malloc-free/%lu", (unsigned long) largeSizes[i]);
+    xBenchRun(&opts, name, benchLargeMallocFree, NUMBER_OPS / 16,
+        largeSizes[i], 1);
+  }
+  sprintf(name, "first-touch/64");
+  xBenchRun(&opts, name, benchFirstTouch, NUMBER_OPS / 4, 64, 1);
+  sprintf(name, "first-touch/1008");
+  xBenchRun(&opts, name, benchFirstTouch, NUMBER_OPS / 16, 1008, 1);
+  sprintf(name, "is-bin-addr");
+  xBenchRun(&opts, name, benchIsBinAddr, NUMBER_OPS, 64, 0);
+  return 0;
+}
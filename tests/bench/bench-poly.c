@@ -0,0 +1,317 @@
+/**
+ * \file   bench-poly.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Computer algebra workload: Polynomials are sorted linked lists of
+ *         terms, a term being a coefficient modulo a small prime together
+ *         with an exponent vector whose first entry is the total degree, as
+ *         monomials are represented in Singular. Terms are allocated from
+ *         spec bins, one per length of the exponent vector. Each round
+ *         multiplies two random polynomials term by term: the product of a
+ *         term with a polynomial is a temporary living in a sticky bin of
+ *         the spec bin, it is merged into the result by a sorting merge.
+ *         Each product gets a sticky bin of its own, which is merged into
+ *         the spec bin afterwards, so its pages are reused by the next ones.
+ *         Finally the coefficients of the result are collected into an array
+ *         grown by reallocation and everything is destroyed.
+ *         Each run is done in a child process of its own, so peak RSS is not
+ *         spoiled by the previous ones.
+ *         Usage: bench-poly [-x|-s] [-n <rounds>] [-t <terms>]
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+#include "bench.h"
+
+#define PRIME         32003
+#define MAX_EXPONENT  16
+/* expected number of variables occurring in a random term */
+#define DENSITY       3
+
+struct termStruct {
+  struct termStruct *next;
+  long              coef;
+  unsigned long     exp[];  /**< total degree followed by the exponents */
+};
+
+typedef struct termStruct termType;
+typedef termType*         term;
+
+static int useSystem            = 0;
+static int numberVariables      = 0;
+static size_t termSize          = 0;
+static xBin termBin             = NULL;
+static xBin tempBin             = NULL;
+static unsigned long allocated  = 0;
+
+static inline unsigned int polyRandom(unsigned int *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 8;
+}
+
+static inline term termAlloc(xBin bin)
+{
+  allocated++;
+  return (useSystem ? malloc(termSize) : xAllocBin(bin));
+}
+
+static inline void termFree(term t, xBin bin)
+{
+  if (useSystem)
+    free(t);
+  else
+    xFreeBin(t, bin);
+}
+
+static void polyDelete(term p)
+{
+  term next;
+  for (; NULL != p; p = next)
+  {
+    next  = p->next;
+    termFree(p, termBin);
+  }
+}
+
+/* degree reverse lexicographical ordering, as in Singular the exponent
+ * vector is compared word by word */
+static inline int termCompare(const term t1, const term t2)
+{
+  int i;
+  for (i = 0; i <= numberVariables; i++)
+  {
+    if (t1->exp[i] != t2->exp[i])
+      return (t1->exp[i] > t2->exp[i] ? 1 : -1);
+  }
+  return 0;
+}
+
+/* merges q into p destructively, terms of q are freed or relinked */
+static term polyAdd(term p, term q, xBin qBin)
+{
+  termType head;
+  term tail = &head, next;
+  int cmp;
+
+  while (NULL != p && NULL != q)
+  {
+    cmp = termCompare(p, q);
+    if (cmp > 0)
+    {
+      tail->next  = p;
+      tail        = p;
+      p           = p->next;
+    }
+    else if (cmp < 0)
+    {
+      tail->next  = q;
+      tail        = q;
+      q           = q->next;
+    }
+    else
+    {
+      p->coef = (p->coef + q->coef) % PRIME;
+      next    = q->next;
+      termFree(q, qBin);
+      q       = next;
+      next    = p->next;
+      if (0 == p->coef)
+        termFree(p, termBin);
+      else
+      {
+        tail->next  = p;
+        tail        = p;
+      }
+      p = next;
+    }
+  }
+  tail->next  = (NULL != p ? p : q);
+  return head.next;
+}
+
+/* multiplying by a term keeps the ordering, no sorting is needed */
+static term polyMultTerm(const term p, const term t, xBin bin)
+{
+  termType head;
+  term tail = &head, s;
+  int i;
+
+  for (s = p; NULL != s; s = s->next)
+  {
+    tail->next  = termAlloc(bin);
+    tail        = tail->next;
+    tail->coef  = (s->coef * t->coef) % PRIME;
+    for (i = 0; i <= numberVariables; i++)
+      tail->exp[i]  = s->exp[i] + t->exp[i];
+  }
+  tail->next  = NULL;
+  return head.next;
+}
+
+static term polyMult(const term p, const term q)
+{
+  term r = NULL, t;
+  for (t = p; NULL != t; t = t->next)
+    r = polyAdd(r, polyMultTerm(q, t, tempBin), tempBin);
+  return r;
+}
+
+static term polyRandomPoly(int numberTerms, unsigned int *seed)
+{
+  term p = NULL, t;
+  int i, j;
+  for (i = 0; i < numberTerms; i++)
+  {
+    t         = termAlloc(termBin);
+    t->next   = NULL;
+    t->coef   = 1 + polyRandom(seed) % (PRIME - 1);
+    t->exp[0] = 0;
+    for (j = 1; j <= numberVariables; j++)
+    {
+      t->exp[j] = 0;
+      if (polyRandom(seed) % numberVariables < DENSITY)
+        t->exp[j] = polyRandom(seed) % MAX_EXPONENT;
+      t->exp[0] +=  t->exp[j];
+    }
+    p = polyAdd(p, t, termBin);
+  }
+  return p;
+}
+
+/* returns the number of coefficients of p */
+static long polyCoefficients(const term p, long **coefs)
+{
+  size_t size = 8 * sizeof(long), newSize;
+  long number = 0;
+  term t;
+
+  *coefs  = (useSystem ? malloc(size) : xMalloc(size));
+  for (t = p; NULL != t; t = t->next)
+  {
+    if ((number + 1) * sizeof(long) > size)
+    {
+      newSize = 2 * size;
+      *coefs  = (useSystem ? realloc(*coefs, newSize) :
+                  xReallocSize(*coefs, size, newSize));
+      size    = newSize;
+    }
+    (*coefs)[number++]  = t->coef;
+  }
+  return number;
+}
+
+static void benchPoly(int rounds, int numberTerms)
+{
+  unsigned int seed = 1;
+  long baseline, number, checksum = 0, *coefs;
+  double seconds;
+  term p, q, r;
+  int i;
+
+  termSize  = sizeof(termType) + (numberVariables + 1) * sizeof(unsigned long);
+  baseline  = xBenchResidentBytes();
+  seconds   = xBenchSeconds();
+  if (!useSystem)
+    termBin = xGetSpecBin(termSize);
+  for (i = 0; i < rounds; i++)
+  {
+    p       = polyRandomPoly(numberTerms, &seed);
+    q       = polyRandomPoly(numberTerms, &seed);
+    if (!useSystem)
+      tempBin = xGetStickyBinOfBin(termBin);
+    r       = polyMult(p, q);
+    // the terms of the product stay valid, their pages belong to termBin
+    if (!useSystem)
+      xMergeStickyBinIntoBin(tempBin, termBin);
+    number  = polyCoefficients(r, &coefs);
+    checksum  +=  number + coefs[number / 2];
+    if (useSystem)
+      free(coefs);
+    else
+      xFree(coefs);
+    polyDelete(p);
+    polyDelete(q);
+    polyDelete(r);
+  }
+  if (!useSystem)
+    xUnGetSpecBin(&termBin, 0);
+  seconds = xBenchSeconds() - seconds;
+
+  printf("%-14s %5d %6lu %10.3f %10.2f %10ldk %10ldk %12ld\n",
+      (useSystem ? "system malloc" : "xmalloc"), numberVariables,
+      (unsigned long) termSize, seconds, allocated / seconds / 1e6,
+      xBenchPeakResidentBytes() / 1024, baseline / 1024, checksum);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  static const int variables[] = { 2, 4, 8, 16, 32 };
+  int allocators[2] = { 1, 1 };
+  int rounds = 20, numberTerms = 200, opt, v, s, status;
+  pid_t pid;
+
+  while (-1 != (opt = getopt(argc, argv, "xsn:t:")))
+  {
+    switch (opt)
+    {
+      case 'x':
+        allocators[1] = 0;
+        break;
+      case 's':
+        allocators[0] = 0;
+        break;
+      case 'n':
+        rounds      = atoi(optarg);
+        break;
+      case 't':
+        numberTerms = atoi(optarg);
+        break;
+      default:
+        rounds  = 0;
+        break;
+    }
+  }
+  if (optind != argc || rounds < 1 || numberTerms < 1)
+  {
+    fprintf(stderr, "usage: %s [-x|-s] [-n <rounds>] [-t <terms>]\n",
+        argv[0]);
+    return 1;
+  }
+
+  printf("malloc          vars  bytes    seconds  Mterms/s   peak RSS   "
+      "start RSS     checksum\n");
+  fflush(stdout);
+  for (v = 0; v < sizeof(variables) / sizeof(variables[0]); v++)
+  {
+    for (s = 0; s < 2; s++)
+    {
+      if (!allocators[s])
+        continue;
+      pid = fork();
+      if (0 == pid)
+      {
+        useSystem       = s;
+        numberVariables = variables[v];
+        benchPoly(rounds, numberTerms);
+        _exit(0);
+      }
+      waitpid(pid, &status, 0);
+      if (!WIFEXITED(status) || 0 != WEXITSTATUS(status))
+      {
+        fprintf(stderr, "bench-poly failed with %d variables\n",
+            variables[v]);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
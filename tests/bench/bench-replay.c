@@ -0,0 +1,294 @@
+/**
+ * \file   bench-replay.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Replays an allocation stream recorded by xRecordStart() /
+ *         xRecordStop() against xmalloc and the system malloc. For each
+ *         allocator throughput, peak live bytes, peak RSS, fragmentation and
+ *         the latency percentiles of each kind of operation are reported.
+ *         Each allocator runs in a child process of its own, so peak RSS is
+ *         not spoiled by the other one.
+ *         Records of several threads are merged by time stamp and replayed
+ *         on one thread since xmalloc is not thread-safe.
+ *         Usage: bench-replay [-x|-s] [-n <repetitions>] <record file>
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+#include "bench.h"
+
+enum xReplayAllocator_e {
+  xReplay_Xmalloc = 0,
+  xReplay_System,
+  xReplay_MaxAllocator
+};
+
+static const char *xReplayAllocatorName[xReplay_MaxAllocator] = {
+  "xmalloc",
+  "system malloc"
+};
+
+static const char *xReplayOpName[xRecord_MaxOp] = {
+  "Malloc:",
+  "Free:",
+  "Realloc:",
+  "GetSpecBin:",
+  "AllocBin:"
+};
+
+struct xReplayEntryStruct {
+  xRecordEntry        entry;
+  unsigned long       index;  /**< position in the file, breaks ties */
+};
+
+typedef struct xReplayEntryStruct xReplayEntry;
+
+static xReplayEntry *entries        = NULL;
+static unsigned long numberEntries  = 0;
+static unsigned long long maxId     = 0;
+static unsigned int numberThreads   = 0;
+
+static int xReplayCompare(const void *a, const void *b)
+{
+  const xReplayEntry *e1  = a;
+  const xReplayEntry *e2  = b;
+  if (e1->entry.tsc != e2->entry.tsc)
+    return (e1->entry.tsc < e2->entry.tsc ? -1 : 1);
+  return (e1->index < e2->index ? -1 : 1);
+}
+
+static int xReplayLoad(const char *fileName)
+{
+  xRecordReader reader;
+  xRecordEntry entry;
+  unsigned long size  = 0;
+  int ret;
+
+  if (0 != xRecordOpen(&reader, fileName))
+    return -1;
+  while (1 == (ret = xRecordRead(&reader, &entry)))
+  {
+    if (numberEntries == size)
+    {
+      size    = (0 == size ? 65536 : 2 * size);
+      entries = realloc(entries, size * sizeof(xReplayEntry));
+    }
+    entries[numberEntries].entry  = entry;
+    entries[numberEntries].index  = numberEntries;
+    numberEntries++;
+    if (entry.id > maxId)
+      maxId = entry.id;
+    if (entry.oldId > maxId)
+      maxId = entry.oldId;
+    if (entry.thread >= numberThreads)
+      numberThreads = entry.thread + 1;
+  }
+  xRecordClose(&reader);
+  if (0 != ret)
+    return -1;
+  qsort(entries, numberEntries, sizeof(xReplayEntry), xReplayCompare);
+  return 0;
+}
+
+/* the application touches its memory, so should the replay */
+static inline void xReplayTouch(void *addr, size_t size)
+{
+  memset(addr, 0x5a, size);
+}
+
+static void xReplay(int allocator, int repetitions)
+{
+  void **addrs    = calloc(maxId + 1, sizeof(void*));
+  size_t *sizes   = calloc(maxId + 1, sizeof(size_t));
+  xBin *bins      = calloc(maxId + 1, sizeof(xBin));
+  xHistogramType *latencies = calloc(xRecord_MaxOp, sizeof(xHistogramType));
+  unsigned long long start, ticks = 0, ops = 0;
+  long live = 0, peakLive = 0, baseline;
+  double seconds;
+  unsigned long i, id;
+  int r;
+
+  baseline  = xBenchResidentBytes();
+  seconds   = xBenchSeconds();
+  for (r = 0; r < repetitions; r++)
+  {
+    for (i = 0; i < numberEntries; i++)
+    {
+      xRecordEntry *e = &entries[i].entry;
+      void *addr;
+      xBin bin;
+      switch (e->op)
+      {
+        case xRecord_Malloc:
+          start = xReadTsc();
+          addr  = (xReplay_System == allocator ? malloc(e->size) :
+                    xMalloc(e->size));
+          start = xReadTsc() - start;
+          xReplayTouch(addr, e->size);
+          addrs[e->id]  = addr;
+          sizes[e->id]  = e->size;
+          live          +=  e->size;
+          break;
+        case xRecord_Free:
+          if (NULL == (addr = addrs[e->id]))
+            continue;
+          start = xReadTsc();
+          if (xReplay_System == allocator)
+            free(addr);
+          else
+            xFree(addr);
+          start = xReadTsc() - start;
+          addrs[e->id]  = NULL;
+          live          -=  sizes[e->id];
+          break;
+        case xRecord_Realloc:
+          addr  = addrs[e->oldId];
+          start = xReadTsc();
+          if (xReplay_System == allocator)
+            addr  = realloc(addr, e->size);
+          else
+            addr  = (NULL == addr ? xMalloc(e->size) :
+                      xReallocSize(addr, sizes[e->oldId], e->size));
+          start = xReadTsc() - start;
+          if (NULL != addrs[e->oldId])
+          {
+            live  -=  sizes[e->oldId];
+            if (e->size > sizes[e->oldId])
+              xReplayTouch((char*) addr + sizes[e->oldId],
+                  e->size - sizes[e->oldId]);
+          }
+          else
+            xReplayTouch(addr, e->size);
+          addrs[e->oldId] = NULL;
+          addrs[e->id]    = addr;
+          sizes[e->id]    = e->size;
+          live            +=  e->size;
+          break;
+        case xRecord_GetSpecBin:
+          start = xReadTsc();
+          bin   = (xReplay_System == allocator ? NULL : xGetSpecBin(e->size));
+          start = xReadTsc() - start;
+          bins[e->id] = bin;
+          break;
+        case xRecord_AllocBin:
+          bin   = NULL;
+          if (xReplay_Xmalloc == allocator)
+            bin = (0 != e->oldId && NULL != bins[e->oldId] ? bins[e->oldId] :
+                    xGetSpecBin(e->size));
+          start = xReadTsc();
+          addr  = (xReplay_System == allocator ? malloc(e->size) :
+                    xAllocBin(bin));
+          start = xReadTsc() - start;
+          xReplayTouch(addr, e->size);
+          addrs[e->id]  = addr;
+          sizes[e->id]  = e->size;
+          live          +=  e->size;
+          break;
+        default:
+          continue;
+      }
+      xHistogramRecord(&latencies[e->op], start);
+      ticks +=  start;
+      ops++;
+      if (live > peakLive)
+        peakLive  = live;
+    }
+    // free what the application did not free itself
+    for (id = 1; id <= maxId; id++)
+    {
+      if (NULL == addrs[id])
+        continue;
+      if (xReplay_System == allocator)
+        free(addrs[id]);
+      else
+        xFree(addrs[id]);
+      addrs[id] = NULL;
+      live      -=  sizes[id];
+    }
+  }
+  seconds = xBenchSeconds() - seconds;
+
+  printf("%s: %d x %lu records, %u thread(s)\n",
+      xReplayAllocatorName[allocator], repetitions, numberEntries,
+      numberThreads);
+  printf("  throughput:     %10.3f Mops/s (allocator time only), "
+      "%.3f s wall\n",
+      ops / (ticks / xTscTicksPerNanosecond()) * 1e3, seconds);
+  printf("  peak live:      %10ldk\n", peakLive / 1024);
+  printf("  peak RSS:       %10ldk (%ldk at start)\n",
+      xBenchPeakResidentBytes() / 1024, baseline / 1024);
+  if (peakLive > 0)
+    printf("  fragmentation:  %10.3f (peak RSS growth / peak live)\n",
+        (double) (xBenchPeakResidentBytes() - baseline) / peakLive);
+  printf("Latencies:            Count:      Mean:       p50:       p90:"
+      "       p99:     p99.9:       Max:\n");
+  for (r = 0; r < xRecord_MaxOp; r++)
+    if (0 != latencies[r].count)
+      xPrintHistogram(stdout, xReplayOpName[r], &latencies[r]);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  int allocators[xReplay_MaxAllocator] = { 1, 1 };
+  int repetitions = 1, opt, a, status;
+  pid_t pid;
+
+  while (-1 != (opt = getopt(argc, argv, "xsn:")))
+  {
+    switch (opt)
+    {
+      case 'x':
+        allocators[xReplay_System]  = 0;
+        break;
+      case 's':
+        allocators[xReplay_Xmalloc] = 0;
+        break;
+      case 'n':
+        repetitions = atoi(optarg);
+        break;
+      default:
+        optind  = argc;
+        break;
+    }
+  }
+  if (optind != argc - 1 || repetitions < 1)
+  {
+    fprintf(stderr, "usage: %s [-x|-s] [-n <repetitions>] <record file>\n",
+        argv[0]);
+    return 1;
+  }
+  if (0 != xReplayLoad(argv[optind]))
+  {
+    fprintf(stderr, "%s is no valid xmalloc record file\n", argv[optind]);
+    return 1;
+  }
+  // calibrate once in the parent, children inherit the cached value
+  xTscTicksPerNanosecond();
+  for (a = 0; a < xReplay_MaxAllocator; a++)
+  {
+    if (!allocators[a])
+      continue;
+    pid = fork();
+    if (0 == pid)
+    {
+      xReplay(a, repetitions);
+      _exit(0);
+    }
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || 0 != WEXITSTATUS(status))
+    {
+      fprintf(stderr, "replay with %s failed\n", xReplayAllocatorName[a]);
+      return 1;
+    }
+  }
+  free(entries);
+  return 0;
+}
@@ -0,0 +1,404 @@
+/**
+ * \file   bench-scaling.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Multi-threaded allocator stress patterns run at 1..N threads:
+ *           larson          server simulation, blocks are handed over to
+ *                           other threads and freed there
+ *           cache-thrash    active false sharing, each thread allocates,
+ *                           writes and frees small blocks
+ *           cache-scratch   passive false sharing, each thread frees a
+ *                           block allocated by the main thread and writes
+ *                           to blocks it allocates afterwards
+ *           prod-cons       each thread allocates into a queue its
+ *                           neighbour frees from
+ *           private-churn   each thread allocates and frees privately
+ *         xmalloc is not thread-safe, so its calls are serialized by one
+ *         global mutex; the results show what this costs compared to the
+ *         system malloc. Each run is done in a child process of its own,
+ *         the output is CSV:
+ *           pattern,malloc,threads,seconds,mops,speedup,peak_rss_kb
+ *         Usage: bench-scaling [-t <max threads>] [-n <ops per thread>]
+ *                              [-s|-S] [pattern]
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+#include "bench.h"
+
+#define LARSON_SLOTS    1000
+#define LARSON_ROUNDS   10
+#define QUEUE_SIZE      1024
+#define CACHE_WRITES    100
+
+static int useSystem                = 0;
+static long numberOps               = 1L << 20;
+static int numberThreads            = 1;
+static pthread_mutex_t xLock        = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t barrier;
+
+static inline void* benchAlloc(size_t size)
+{
+  void *addr;
+  if (useSystem)
+    return malloc(size);
+  pthread_mutex_lock(&xLock);
+  addr  = xMalloc(size);
+  pthread_mutex_unlock(&xLock);
+  return addr;
+}
+
+static inline void benchFree(void *addr)
+{
+  if (useSystem)
+  {
+    free(addr);
+    return;
+  }
+  pthread_mutex_lock(&xLock);
+  xFree(addr);
+  pthread_mutex_unlock(&xLock);
+}
+
+static inline unsigned int benchRandom(unsigned int *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 8;
+}
+
+/************************************************
+ * LARSON
+ ***********************************************/
+static void ***larsonSlots;
+
+static void larsonInit()
+{
+  int t, i;
+  unsigned int seed = 1;
+  larsonSlots = malloc(numberThreads * sizeof(void**));
+  for (t = 0; t < numberThreads; t++)
+  {
+    larsonSlots[t]  = malloc(LARSON_SLOTS * sizeof(void*));
+    for (i = 0; i < LARSON_SLOTS; i++)
+      larsonSlots[t][i] = benchAlloc(16 + benchRandom(&seed) % 497);
+  }
+}
+
+static void larson(int thread)
+{
+  unsigned int seed = thread + 1;
+  long i, round;
+  for (round = 0; round < LARSON_ROUNDS; round++)
+  {
+    // after each round a thread takes over the blocks of its neighbour,
+    // as a new server thread would in the original benchmark
+    void **slots  = larsonSlots[(thread + round) % numberThreads];
+    for (i = 0; i < numberOps / LARSON_ROUNDS; i++)
+    {
+      unsigned int slot = benchRandom(&seed) % LARSON_SLOTS;
+      benchFree(slots[slot]);
+      slots[slot]   = benchAlloc(16 + benchRandom(&seed) % 497);
+      *(char *) slots[slot] = (char) i;
+    }
+    pthread_barrier_wait(&barrier);
+  }
+}
+
+static void larsonFinish()
+{
+  int t, i;
+  for (t = 0; t < numberThreads; t++)
+  {
+    for (i = 0; i < LARSON_SLOTS; i++)
+      benchFree(larsonSlots[t][i]);
+    free(larsonSlots[t]);
+  }
+  free(larsonSlots);
+}
+
+/************************************************
+ * CACHE THRASH & SCRATCH
+ ***********************************************/
+static inline void cacheWrite(volatile char *addr)
+{
+  int i, j;
+  for (i = 0; i < CACHE_WRITES; i++)
+    for (j = 0; j < 8; j++)
+      addr[j]++;
+}
+
+static void cacheThrash(int thread)
+{
+  long i;
+  for (i = 0; i < numberOps / CACHE_WRITES; i++)
+  {
+    char *addr  = benchAlloc(8);
+    cacheWrite(addr);
+    benchFree(addr);
+  }
+}
+
+static void **scratchBlocks;
+
+static void cacheScratchInit()
+{
+  int t;
+  scratchBlocks = malloc(numberThreads * sizeof(void*));
+  // blocks of different threads are likely to share a cache line
+  for (t = 0; t < numberThreads; t++)
+    scratchBlocks[t]  = benchAlloc(8);
+}
+
+static void cacheScratch(int thread)
+{
+  long i;
+  benchFree(scratchBlocks[thread]);
+  for (i = 0; i < numberOps / CACHE_WRITES; i++)
+  {
+    char *addr  = benchAlloc(8);
+    cacheWrite(addr);
+    benchFree(addr);
+  }
+}
+
+static void cacheScratchFinish()
+{
+  free(scratchBlocks);
+}
+
+/************************************************
+ * PRODUCER CONSUMER
+ ***********************************************/
+struct queueStruct {
+  void * volatile     slots[QUEUE_SIZE];
+  volatile long       head __attribute__ ((aligned(64)));
+  volatile long       tail __attribute__ ((aligned(64)));
+};
+
+static struct queueStruct *queues;
+
+static void prodConsInit()
+{
+  queues  = calloc(numberThreads, sizeof(struct queueStruct));
+}
+
+static inline int queuePop(struct queueStruct *queue)
+{
+  long tail = queue->tail;
+  void *addr;
+  if (tail == queue->head)
+    return 0;
+  addr  = queue->slots[tail % QUEUE_SIZE];
+  __sync_synchronize();
+  queue->tail = tail + 1;
+  benchFree(addr);
+  return 1;
+}
+
+/* thread i produces into queue i and consumes from queue i-1 */
+static void prodCons(int thread)
+{
+  struct queueStruct *out = &queues[thread];
+  struct queueStruct *in  = &queues[(thread + numberThreads - 1) %
+                                      numberThreads];
+  long produced = 0, consumed = 0;
+  int progress;
+
+  while (produced < numberOps || consumed < numberOps)
+  {
+    progress  = 0;
+    if (produced < numberOps && out->head - out->tail < QUEUE_SIZE)
+    {
+      void *addr  = benchAlloc(16 + (produced & 255));
+      *(long *) addr  = produced;
+      out->slots[out->head % QUEUE_SIZE]  = addr;
+      __sync_synchronize();
+      out->head = out->head + 1;
+      produced++;
+      progress  = 1;
+    }
+    if (consumed < numberOps && queuePop(in))
+    {
+      consumed++;
+      progress  = 1;
+    }
+    if (!progress)
+      sched_yield();
+  }
+}
+
+static void prodConsFinish()
+{
+  free(queues);
+}
+
+/************************************************
+ * PRIVATE CHURN
+ ***********************************************/
+static void privateChurn(int thread)
+{
+  void *addrs[256];
+  unsigned int seed = thread + 1;
+  long i;
+  int j;
+  for (i = 0; i < numberOps; i += 256)
+  {
+    for (j = 0; j < 256; j++)
+    {
+      addrs[j]  = benchAlloc(8 + benchRandom(&seed) % 1000);
+      *(char *) addrs[j]  = (char) j;
+    }
+    for (j = 0; j < 256; j++)
+      benchFree(addrs[j]);
+  }
+}
+
+/************************************************
+ * DRIVER
+ ***********************************************/
+struct patternStruct {
+  const char  *name;
+  void        (*init)();
+  void        (*run)(int thread);
+  void        (*finish)();
+  int         opsFactor;  /**< operations done per counted op */
+};
+
+static const struct patternStruct patterns[] = {
+  { "larson",         larsonInit,       larson,       larsonFinish,       1 },
+  { "cache-thrash",   NULL,             cacheThrash,  NULL,               CACHE_WRITES },
+  { "cache-scratch",  cacheScratchInit, cacheScratch, cacheScratchFinish, CACHE_WRITES },
+  { "prod-cons",      prodConsInit,     prodCons,     prodConsFinish,     1 },
+  { "private-churn",  NULL,             privateChurn, NULL,               1 }
+};
+
+static void *benchThread(void *arg)
+{
+  const struct patternStruct *pattern = arg;
+  static volatile int nextThread  = 0;
+  int thread  = __sync_fetch_and_add(&nextThread, 1) % numberThreads;
+  pthread_barrier_wait(&barrier);
+  pattern->run(thread);
+  return NULL;
+}
+
+/* returns the number of operations per second */
+static double benchPattern(const struct patternStruct *pattern)
+{
+  pthread_t *threads  = malloc(numberThreads * sizeof(pthread_t));
+  double seconds;
+  int t;
+
+  pthread_barrier_init(&barrier, NULL, numberThreads + 1);
+  if (NULL != pattern->init)
+    pattern->init();
+  for (t = 0; t < numberThreads; t++)
+    pthread_create(&threads[t], NULL, benchThread, (void *) pattern);
+  seconds = xBenchSeconds();
+  pthread_barrier_wait(&barrier);
+  // larson synchronizes after each round
+  if (larson == pattern->run)
+    for (t = 0; t < LARSON_ROUNDS; t++)
+      pthread_barrier_wait(&barrier);
+  for (t = 0; t < numberThreads; t++)
+    pthread_join(threads[t], NULL);
+  seconds = xBenchSeconds() - seconds;
+  if (NULL != pattern->finish)
+    pattern->finish();
+  pthread_barrier_destroy(&barrier);
+  free(threads);
+  printf("%.4f,", seconds);
+  return (double) numberThreads * (numberOps / pattern->opsFactor) / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+  int maxThreads  = (int) sysconf(_SC_NPROCESSORS_ONLN), mode = 0;
+  int opt, p, s, fd[2];
+  struct rusage usage;
+  const char *filter  = NULL;
+  pid_t pid;
+
+  while (-1 != (opt = getopt(argc, argv, "t:n:sS")))
+  {
+    switch (opt)
+    {
+      case 't':
+        maxThreads  = atoi(optarg);
+        break;
+      case 'n':
+        numberOps   = atol(optarg);
+        break;
+      case 's':
+        mode  = 1;
+        break;
+      case 'S':
+        mode  = 2;
+        break;
+      default:
+        maxThreads  = 0;
+        break;
+    }
+  }
+  if (optind < argc)
+    filter  = argv[optind++];
+  if (optind < argc || maxThreads < 1 || numberOps < 1)
+  {
+    fprintf(stderr, "usage: %s [-t <max threads>] [-n <ops per thread>] "
+        "[-s|-S] [pattern]\n", argv[0]);
+    return 1;
+  }
+
+  printf("pattern,malloc,threads,seconds,mops,speedup,peak_rss_kb\n");
+  fflush(stdout);
+  for (p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+  {
+    if (NULL != filter && NULL == strstr(patterns[p].name, filter))
+      continue;
+    for (s = (2 == mode ? 1 : 0); s <= (0 == mode ? 0 : 1); s++)
+    {
+      double base = 0.0;
+      for (numberThreads = 1; numberThreads <= maxThreads; numberThreads++)
+      {
+        double rate;
+        // the child reports its throughput back for the speedup column
+        if (0 != pipe(fd))
+          return 1;
+        pid = fork();
+        if (0 == pid)
+        {
+          close(fd[0]);
+          useSystem = s;
+          printf("%s,%s,%d,", patterns[p].name, (s ? "system" : "xmalloc"),
+              numberThreads);
+          rate  = benchPattern(&patterns[p]);
+          printf("%.3f,", rate / 1e6);
+          fflush(stdout);
+          if (sizeof(rate) != write(fd[1], &rate, sizeof(rate)))
+            _exit(1);
+          _exit(0);
+        }
+        close(fd[1]);
+        if (sizeof(rate) != read(fd[0], &rate, sizeof(rate)))
+          rate  = 0.0;
+        close(fd[0]);
+        wait4(pid, NULL, 0, &usage);
+        if (1 == numberThreads)
+          base  = rate;
+        printf("%.3f,%ld\n", (base > 0.0 ? rate / base : 0.0),
+            usage.ru_maxrss);
+        fflush(stdout);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * \file   bench.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Microbenchmark harness shared by the benchmarks of xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#ifdef __XMALLOC_HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/************************************************
+ * HARDWARE PERFORMANCE COUNTERS
+ ***********************************************/
+static int xBenchCounterFd[xBenchCounter_MaxCounter] = { -1, -1, -1, -1, -1 };
+
+static const char *xBenchCounterName[xBenchCounter_MaxCounter] = {
+  "instr/op",
+  "br-miss/op",
+  "L1d-miss/op",
+  "LLC-miss/op",
+  "dTLB-miss/op"
+};
+
+#ifdef __XMALLOC_HAVE_LINUX_PERF_EVENT_H
+#define __XMALLOC_BENCH_CACHE_READ_MISS(cache)                        \
+  ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) |                     \
+   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+  unsigned int        type;
+  unsigned long long  config;
+} xBenchCounterEvent[xBenchCounter_MaxCounter] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { PERF_TYPE_HW_CACHE, __XMALLOC_BENCH_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+  { PERF_TYPE_HW_CACHE, __XMALLOC_BENCH_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) },
+  { PERF_TYPE_HW_CACHE, __XMALLOC_BENCH_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB) }
+};
+
+int xBenchCountersOpen()
+{
+  struct perf_event_attr attr;
+  int i, opened = 0;
+
+  for (i = 0; i < xBenchCounter_MaxCounter; i++)
+  {
+    if (-1 != xBenchCounterFd[i])
+    {
+      opened++;
+      continue;
+    }
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = xBenchCounterEvent[i].type;
+    attr.config         = xBenchCounterEvent[i].config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                          PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // counters are opened one by one, so that a group does not fail as a
+    // whole if the CPU cannot schedule all of them at once
+    xBenchCounterFd[i]  = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (-1 != xBenchCounterFd[i])
+      opened++;
+  }
+  return opened;
+}
+
+void xBenchCountersStart()
+{
+  int i;
+  for (i = 0; i < xBenchCounter_MaxCounter; i++)
+  {
+    if (-1 == xBenchCounterFd[i])
+      continue;
+    ioctl(xBenchCounterFd[i], PERF_EVENT_IOC_RESET, 0);
+    ioctl(xBenchCounterFd[i], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void xBenchCountersStop(double *values)
+{
+  unsigned long long data[3];
+  int i;
+  for (i = 0; i < xBenchCounter_MaxCounter; i++)
+    if (-1 != xBenchCounterFd[i])
+      ioctl(xBenchCounterFd[i], PERF_EVENT_IOC_DISABLE, 0);
+  for (i = 0; i < xBenchCounter_MaxCounter; i++)
+  {
+    values[i] = -1.0;
+    if (-1 == xBenchCounterFd[i] ||
+        sizeof(data) != read(xBenchCounterFd[i], data, sizeof(data)) ||
+        0 == data[2])
+      continue;
+    // data = { value, time enabled, time running }
+    values[i] = (double) data[0] * data[1] / data[2];
+  }
+}
+#else
+int xBenchCountersOpen()
+{
+  return 0;
+}
+
+void xBenchCountersStart()
+{
+}
+
+void xBenchCountersStop(double *values)
+{
+  int i;
+  for (i = 0; i < xBenchCounter_MaxCounter; i++)
+    values[i] = -1.0;
+}
+#endif
+
+void xBenchCountersClose()
+{
+  int i;
+  for (i = 0; i < xBenchCounter_MaxCounter; i++)
+  {
+    if (-1 != xBenchCounterFd[i])
+      close(xBenchCounterFd[i]);
+    xBenchCounterFd[i]  = -1;
+  }
+}
+
+/************************************************
+ * MICROBENCHMARK HARNESS
+ ***********************************************/
+
+int xBenchParseOpts(xBenchOpts *opts, int argc, char *argv[])
+{
+  int opt;
+
+  opts->warmup      = 2;
+  opts->repetitions = 7;
+  opts->system      = 0;
+  opts->counters    = 0;
+  opts->filter      = NULL;
+  while (-1 != (opt = getopt(argc, argv, "w:r:sSp")))
+  {
+    switch (opt)
+    {
+      case 'w':
+        opts->warmup      = atoi(optarg);
+        break;
+      case 'r':
+        opts->repetitions = atoi(optarg);
+        break;
+      case 's':
+        opts->system      = 1;
+        break;
+      case 'S':
+        opts->system      = 2;
+        break;
+      case 'p':
+        opts->counters    = 1;
+        break;
+      default:
+        return -1;
+    }
+  }
+  if (optind < argc)
+    opts->filter  = argv[optind++];
+  if (optind < argc || opts->warmup < 0 || opts->repetitions < 1)
+    return -1;
+  if (opts->counters && 0 == xBenchCountersOpen())
+  {
+    fprintf(stderr, "hardware counters are not available, see "
+        "/proc/sys/kernel/perf_event_paranoid\n");
+    opts->counters  = 0;
+  }
+  return 0;
+}
+
+static int xBenchCompare(const void *a, const void *b)
+{
+  double d1 = *(const double *) a;
+  double d2 = *(const double *) b;
+  return (d1 < d2 ? -1 : (d1 > d2));
+}
+
+void xBenchPrintHeader(const xBenchOpts *opts)
+{
+  int i;
+  printf("%-32s %-7s %10s %10s %10s", "benchmark", "malloc", "ns/op",
+      "min ns/op", "cycles/op");
+  if (opts->counters)
+    for (i = 0; i < xBenchCounter_MaxCounter; i++)
+      printf(" %12s", xBenchCounterName[i]);
+  printf("\n");
+}
+
+static void xBenchRunOne(const xBenchOpts *opts, const char *name,
+    xBenchFunc func, long numberOps, size_t size, int system)
+{
+  double *ns      = malloc(opts->repetitions * sizeof(double));
+  double *cycles  = malloc(opts->repetitions * sizeof(double));
+  double *counts  = malloc(opts->repetitions * xBenchCounter_MaxCounter *
+                      sizeof(double));
+  double seconds, values[xBenchCounter_MaxCounter];
+  unsigned long long tsc;
+  int i, j;
+
+  for (i = 0; i < opts->warmup; i++)
+    func(numberOps, size, system);
+  for (i = 0; i < opts->repetitions; i++)
+  {
+    if (opts->counters)
+      xBenchCountersStart();
+    seconds   = xBenchSeconds();
+    tsc       = xReadTsc();
+    func(numberOps, size, system);
+    tsc       = xReadTsc() - tsc;
+    seconds   = xBenchSeconds() - seconds;
+    if (opts->counters)
+      xBenchCountersStop(values);
+    ns[i]     = seconds * 1e9 / numberOps;
+    cycles[i] = (double) tsc / numberOps;
+    // counts are stored counter by counter to sort each of them
+    for (j = 0; opts->counters && j < xBenchCounter_MaxCounter; j++)
+      counts[j * opts->repetitions + i] = values[j] / numberOps;
+  }
+  qsort(ns, opts->repetitions, sizeof(double), xBenchCompare);
+  qsort(cycles, opts->repetitions, sizeof(double), xBenchCompare);
+  printf("%-32s %-7s %10.2f %10.2f %10.2f", name,
+      (system ? "system" : "xmalloc"), ns[opts->repetitions / 2], ns[0],
+      cycles[opts->repetitions / 2]);
+  for (j = 0; opts->counters && j < xBenchCounter_MaxCounter; j++)
+  {
+    double *count = &counts[j * opts->repetitions];
+    qsort(count, opts->repetitions, sizeof(double), xBenchCompare);
+    if (count[0] < 0.0)
+      printf(" %12s", "-");
+    else
+      printf(" %12.3f", count[opts->repetitions / 2]);
+  }
+  printf("\n");
+  fflush(stdout);
+  free(ns);
+  free(cycles);
+  free(counts);
+}
+
+void xBenchRun(const xBenchOpts *opts, const char *name, xBenchFunc func,
+    long numberOps, size_t size, int hasSystem)
+{
+  if (NULL != opts->filter && NULL == strstr(name, opts->filter))
+    return;
+  if (2 != opts->system)
+    xBenchRunOne(opts, name, func, numberOps, size, 0);
+  if (0 != opts->system && hasSystem)
+    xBenchRunOne(opts, name, func, numberOps, size, 1);
+}
@@ -0,0 +1,218 @@
+/**
+ * \file   bench.h
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Common helpers for the benchmarks of xmalloc: wall clock time,
+ *         resident set size of the process, hardware performance counters
+ *         and a harness running isolated microbenchmarks with warmup and
+ *         repetitions.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#ifndef XMALLOC_BENCH_H
+#define XMALLOC_BENCH_H
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "xmalloc-config.h"
+#include "tsc.h"
+
+/**
+ * \fn static inline double xBenchSeconds()
+ *
+ * \brief Reads the monotonic wall clock.
+ *
+ * \return current time in seconds
+ *
+ */
+static inline double xBenchSeconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + 1e-9 * (double) ts.tv_nsec;
+}
+
+/**
+ * \fn static inline long xBenchResidentBytes()
+ *
+ * \brief Reads the current resident set size from /proc/self/statm.
+ *
+ * \return resident bytes, -1 if /proc is not available
+ *
+ */
+static inline long xBenchResidentBytes()
+{
+  long size, resident = -1;
+  FILE *file  = fopen("/proc/self/statm", "r");
+  if (NULL == file)
+    return -1;
+  if (2 != fscanf(file, "%ld %ld", &size, &resident))
+    resident  = -1;
+  fclose(file);
+  return (resident < 0 ? -1 : resident * sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * \fn static inline long xBenchPeakResidentBytes()
+ *
+ * \brief Gets the peak resident set size of the process.
+ *
+ * \return peak resident bytes
+ *
+ */
+static inline long xBenchPeakResidentBytes()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss * 1024L;
+}
+
+/**
+ * \fn static inline void xBenchEscape(void *addr)
+ *
+ * \brief Keeps the compiler from optimizing away allocations whose result is
+ * not used otherwise.
+ *
+ * \param addr address that is considered to be used
+ *
+ */
+static inline void xBenchEscape(void *addr)
+{
+  __asm__ __volatile__ ("" : : "r" (addr) : "memory");
+}
+
+/************************************************
+ * HARDWARE PERFORMANCE COUNTERS
+ ***********************************************/
+/**
+ * \brief Hardware events counted by \c xBenchCountersStart() and
+ * \c xBenchCountersStop() .
+ */
+enum xBenchCounter_e {
+  xBenchCounter_Instructions = 0, /**< retired instructions */
+  xBenchCounter_BranchMisses,     /**< mispredicted branches */
+  xBenchCounter_L1dMisses,        /**< L1 data cache read misses */
+  xBenchCounter_LlcMisses,        /**< last level cache read misses */
+  xBenchCounter_DtlbMisses,       /**< data TLB read misses */
+  xBenchCounter_MaxCounter
+};
+
+/**
+ * \fn int xBenchCountersOpen()
+ *
+ * \brief Opens the hardware counters of the calling thread via
+ * perf_event_open(). Only user space is counted. Counters which are not
+ * supported by the CPU or not permitted, e.g. by
+ * /proc/sys/kernel/perf_event_paranoid, stay closed.
+ *
+ * \return number of counters opened, 0 if none is available
+ *
+ */
+int xBenchCountersOpen();
+
+/**
+ * \fn void xBenchCountersClose()
+ *
+ * \brief Closes all counters opened by \c xBenchCountersOpen() .
+ *
+ */
+void xBenchCountersClose();
+
+/**
+ * \fn void xBenchCountersStart()
+ *
+ * \brief Resets and enables all open counters.
+ *
+ */
+void xBenchCountersStart();
+
+/**
+ * \fn void xBenchCountersStop(double *values)
+ *
+ * \brief Disables all open counters and reads them. Values are scaled up if
+ * the kernel had to multiplex the counters.
+ *
+ * \param values array of \c xBenchCounter_MaxCounter values, -1 for
+ * counters not available
+ *
+ */
+void xBenchCountersStop(double *values);
+
+/************************************************
+ * MICROBENCHMARK HARNESS
+ ***********************************************/
+/**
+ * \brief A microbenchmark performs \c numberOps operations of size \c size
+ * with xmalloc or, if \c system is set, with the system malloc.
+ */
+typedef void (*xBenchFunc)(long numberOps, size_t size, int system);
+
+/**
+ * \struct xBenchOptsStruct
+ *
+ * \brief Options of a microbenchmark run.
+ */
+struct xBenchOptsStruct {
+  int         warmup;       /**< number of runs not taken into account */
+  int         repetitions;  /**< number of measured runs */
+  int         system;       /**< 0: xmalloc, 1: xmalloc and system malloc,
+                                 2: system malloc only */
+  int         counters;     /**< report hardware counters per op */
+  const char  *filter;      /**< run only benchmarks containing this */
+};
+
+typedef struct xBenchOptsStruct xBenchOpts;
+
+/**
+ * \fn int xBenchParseOpts(xBenchOpts *opts, int argc, char *argv[])
+ *
+ * \brief Parses the common options of the benchmarks:
+ *   -w <warmup> -r <repetitions> -s (compare to system malloc)
+ *   -S (system malloc only) -p (hardware counters) [filter]
+ *
+ * \return 0 on success, -1 on invalid options
+ *
+ */
+int xBenchParseOpts(xBenchOpts *opts, int argc, char *argv[]);
+
+/**
+ * \fn void xBenchRun(const xBenchOpts *opts, const char *name,
+ * xBenchFunc func, long numberOps, size_t size, int hasSystem)
+ *
+ * \brief Runs \c func \c opts->warmup times without and
+ * \c opts->repetitions times with measuring and prints median and minimum
+ * of ns/op and cycles/op. Time stamp ticks are reported as cycles. If
+ * \c opts->counters is set, the medians of the hardware counters per op are
+ * printed, too.
+ *
+ * \param opts \c xBenchOpts
+ *
+ * \param name name of the benchmark
+ *
+ * \param func \c xBenchFunc to be measured
+ *
+ * \param numberOps number of operations of one run
+ *
+ * \param size size passed to \c func
+ *
+ * \param hasSystem set if \c func has a system malloc variant
+ *
+ */
+void xBenchRun(const xBenchOpts *opts, const char *name, xBenchFunc func,
+    long numberOps, size_t size, int hasSystem);
+
+/**
+ * \fn void xBenchPrintHeader(const xBenchOpts *opts)
+ *
+ * \brief Prints the header of the table printed by \c xBenchRun() .
+ *
+ * \param opts \c xBenchOpts
+ *
+ */
+void xBenchPrintHeader(const xBenchOpts *opts);
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * \file   test-xAllocator.cc
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the C++ allocator and the replacement of operator
+ *         new and operator delete.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <list>
+#include <map>
+#include <vector>
+#include <string>
+#include "xmalloc-config.h"
+#define XMALLOC_REPLACE_OPERATOR_NEW
+#include "xmalloc.hpp"
+
+struct node {
+  long  data[12];
+};
+
+int main() {
+  typedef std::map<int, int, std::less<int>,
+          xm::allocator<std::pair<const int, int> > > map;
+  std::list<long, xm::allocator<long> > l;
+  std::vector<int, xm::allocator<int> > v;
+  xm::allocator<node> a;
+  map m;
+  node *n, *ns;
+  int *i;
+  int j;
+
+  __XMALLOC_ASSERT(xm::size_class<96>::small);
+  __XMALLOC_ASSERT(!xm::size_class<__XMALLOC_MAX_SMALL_BLOCK_SIZE + 1>::small);
+  __XMALLOC_ASSERT(xm::size_class<sizeof(node)>::bin() ==
+                   xSmallSize2Bin(sizeof(node)));
+#if __cplusplus >= 201103L
+  static_assert(10 == xm::size_class<sizeof(node)>::index,
+                "bin of 96 bytes resolved at compile time");
+#endif
+
+  // typed allocation
+  n = xm::alloc0<node>();
+  __XMALLOC_ASSERT(xGetBinOfAddr(n) == xm::size_class<sizeof(node)>::bin());
+  __XMALLOC_ASSERT(0 == n->data[0] && 0 == n->data[11]);
+  xm::free(n);
+
+  // single objects come from their static bin
+  n = a.allocate(1);
+  __XMALLOC_ASSERT(xIsBinAddr(n));
+  __XMALLOC_ASSERT(xSizeOfBinAddr(n) >= sizeof(node));
+  ns  = a.allocate(100);
+  __XMALLOC_ASSERT(!xIsBinAddr(ns));
+  a.deallocate(ns, 100);
+  a.deallocate(n, 1);
+
+  for (j = 0; j < 10000; j++)
+  {
+    l.push_back(j);
+    m[j]  = -j;
+    v.push_back(j);
+  }
+  __XMALLOC_ASSERT(xIsBinAddr(&l.front()));
+  __XMALLOC_ASSERT(xIsBinAddr(&m.begin()->second));
+  __XMALLOC_ASSERT(!xIsBinAddr(&v[0]));
+  for (j = 0; j < 10000; j += 2)
+    m.erase(j);
+  __XMALLOC_ASSERT(5000 == m.size() && -9999 == m[9999]);
+  l.clear();
+  m.clear();
+  __XMALLOC_ASSERT(xm::allocator<int>() == xm::allocator<long>());
+
+  // operator new and delete are replaced
+  i = new int(5);
+  __XMALLOC_ASSERT(xIsBinAddr(i) && 5 == *i);
+  delete i;
+  i = new int[2000];
+  __XMALLOC_ASSERT(!xIsBinAddr(i));
+  delete[] i;
+  n = new node[3];
+  __XMALLOC_ASSERT(xIsBinAddr(n));
+  delete[] n;
+#if __cpp_aligned_new >= 201606L
+  struct alignas(64) vec {
+    double  v[8];
+  };
+  vec *w  = new vec[5];
+  __XMALLOC_ASSERT(xIsBinAddr(w) &&
+                   0 == (reinterpret_cast<unsigned long>(w) & 63));
+  delete[] w;
+#endif
+  std::string s(100, 'x');
+  __XMALLOC_ASSERT(xIsBinAddr(s.data()));
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * \file   test-xArena.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for arenas of xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_OBJECTS  10000
+
+int main() {
+  long *objects[NUMBER_OBJECTS], *big;
+  xArena arena  = xArenaCreate();
+  xArenaMarkType mark;
+  long usedPages, pages;
+  xPage page;
+  int i;
+
+  // objects are bumped one after the other, aligned and registered
+  objects[0]  = xArenaAlloc(arena, 24);
+  objects[1]  = xArenaAlloc(arena, 20);
+  __XMALLOC_ASSERT((char *) objects[1] == (char *) objects[0] + 24);
+  __XMALLOC_ASSERT(xAddressIsAligned(objects[1]));
+  __XMALLOC_ASSERT(xIsBinAddr(objects[0]));
+  __XMALLOC_ASSERT(xGetBinOfAddr(objects[0]) == __XMALLOC_ARENA_BIN);
+  xArenaDestroy(arena);
+
+  usedPages = info.usedPages;
+  arena = xArenaCreate();
+  for (i = 0; i < NUMBER_OBJECTS / 2; i++)
+  {
+    objects[i]  = xArenaAlloc(arena, 8 * (1 + i % 20));
+    *objects[i] = i;
+  }
+  mark  = xArenaMark(arena);
+  pages = info.usedPages;
+  for (i = NUMBER_OBJECTS / 2; i < NUMBER_OBJECTS; i++)
+  {
+    objects[i]  = xArenaAlloc(arena, 8 * (1 + i % 20));
+    *objects[i] = i;
+  }
+  // objects larger than a page get pages of their own
+  big = xArenaAlloc(arena, 5 * __XMALLOC_SIZEOF_SYSTEM_PAGE);
+  __XMALLOC_ASSERT(xIsBinAddr(big));
+  big[5 * __XMALLOC_SIZEOF_SYSTEM_PAGE / sizeof(long) - 1]  = 1;
+  for (i = 0; i < NUMBER_OBJECTS; i++)
+    __XMALLOC_ASSERT(i == *objects[i]);
+
+  // an accidental free is reported and does not touch the arena
+  xFree(objects[NUMBER_OBJECTS - 1]);
+  xFree(objects[NUMBER_OBJECTS - 2]);
+  xFreeSize(big, 5 * __XMALLOC_SIZEOF_SYSTEM_PAGE);
+  __XMALLOC_ASSERT(NUMBER_OBJECTS - 1 == *objects[NUMBER_OBJECTS - 1]);
+  __XMALLOC_ASSERT(NUMBER_OBJECTS - 2 == *objects[NUMBER_OBJECTS - 2]);
+  __XMALLOC_ASSERT(xArenaAlloc(arena, 8) != objects[NUMBER_OBJECTS - 2]);
+
+  // releasing to the mark gives back the pages allocated since then
+  xArenaRelease(arena, mark);
+  __XMALLOC_ASSERT(pages == info.usedPages);
+  for (i = 0; i < NUMBER_OBJECTS / 2; i++)
+    __XMALLOC_ASSERT(i == *objects[i]);
+  objects[NUMBER_OBJECTS / 2] = xArenaAlloc(arena, 8);
+  __XMALLOC_ASSERT(objects[NUMBER_OBJECTS / 2] == (long *) mark.current);
+  for (page = arena->lastPage; NULL != page; page = page->prev)
+    __XMALLOC_ASSERT(xGetBinOfPage(page) == __XMALLOC_ARENA_BIN);
+
+  // arena pages do not mix with the ones of bins
+  objects[0]  = xMalloc(40);
+  __XMALLOC_ASSERT(xGetBinOfAddr(objects[0]) != __XMALLOC_ARENA_BIN);
+  xFree(objects[0]);
+
+  xArenaDestroy(arena);
+  __XMALLOC_ASSERT(usedPages == info.usedPages);
+  return 0;
+}
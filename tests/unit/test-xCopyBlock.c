@@ -0,0 +1,63 @@
+/**
+ * \file   test-xCopyBlock.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the copy and zero kernels of blocks for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_WORDS  (__XMALLOC_NUMBER_COPY_KERNELS + 20)
+
+int main() {
+  xWord src[NUMBER_WORDS + 2], dst[NUMBER_WORDS + 2];
+  char *p, *q;
+  size_t words, i, offset;
+
+  for (i = 0; i < __XMALLOC_NUMBER_COPY_KERNELS; i++)
+    __XMALLOC_ASSERT(NULL != xCopyKernel[i] && NULL != xZeroKernel[i]);
+
+  // every number of words, also for addresses which are no multiple of 16,
+  // the words around the block are not touched
+  for (offset = 0; offset < 2; offset++)
+  {
+    for (words = 0; words < NUMBER_WORDS; words++)
+    {
+      for (i = 0; i < NUMBER_WORDS + 2; i++)
+      {
+        src[i]  = i + 1;
+        dst[i]  = (xWord) -1;
+      }
+      xCopyBlock(dst + offset, src + offset, words);
+      for (i = 0; i < NUMBER_WORDS + 2; i++)
+        __XMALLOC_ASSERT(dst[i] == (i >= offset && i < offset + words ?
+                                    src[i] : (xWord) -1));
+      xZeroBlock(dst + offset, words);
+      for (i = 0; i < NUMBER_WORDS + 2; i++)
+        __XMALLOC_ASSERT(dst[i] == (i >= offset && i < offset + words ?
+                                    0 : (xWord) -1));
+    }
+  }
+
+  // blocks of all static bins
+  for (i = 0; i <= __XMALLOC_MAX_BIN_INDEX; i++)
+  {
+    words = xStaticBin[i].sizeInWords;
+    p = xAllocBin(&xStaticBin[i]);
+    memset(p, 0x5a, words << __XMALLOC_LOG_SIZEOF_ALIGNMENT);
+    q = xMemDup(p);
+    __XMALLOC_ASSERT(0 == memcmp(p, q, words << __XMALLOC_LOG_SIZEOF_ALIGNMENT));
+    xFreeBin(p, &xStaticBin[i]);
+    p = xAlloc0Bin(&xStaticBin[i]);
+    __XMALLOC_ASSERT(0 == p[0] &&
+                     0 == p[(words << __XMALLOC_LOG_SIZEOF_ALIGNMENT) - 1]);
+    xFree(p);
+    xFree(q);
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * \file   test-xFreePagesFromRegion.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for giving pages back to their regions for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_BLOCKS   40000
+#define NUMBER_BATCH    2000
+#define NUMBER_BATCHES  64
+
+int main() {
+  static void *blocks[NUMBER_BLOCKS];
+  xBin bin  = xSmallSize2Bin(512);
+  xRegion region;
+  int i, j, number;
+
+  // the region of a batch stays mapped when the batch is freed, the next
+  // batch gets its pages from the same region
+  for (i = 0; i < NUMBER_BATCH; i++)
+    blocks[i] = xAllocBin(bin);
+  region  = xBaseRegion;
+  for (i = 0; i < NUMBER_BATCH; i++)
+    xFreeBin(blocks[i], bin);
+  __XMALLOC_ASSERT(NULL == bin->lastPage);
+  __XMALLOC_ASSERT(1 == xNumberEmptyRegions);
+  __XMALLOC_ASSERT(0 == region->numberUsedPages);
+  __XMALLOC_ASSERT(xBaseRegion == region);
+  __XMALLOC_ASSERT(xIsBinAddr(blocks[0]));
+  for (j = 0; j < NUMBER_BATCHES; j++)
+  {
+    for (i = 0; i < NUMBER_BATCH; i++)
+    {
+      blocks[i] = xAllocBin(bin);
+      __XMALLOC_ASSERT(0 == xNumberEmptyRegions);
+    }
+    __XMALLOC_ASSERT(xBaseRegion == region);
+    for (i = 0; i < NUMBER_BATCH; i++)
+      xFreeBin(blocks[i], bin);
+    __XMALLOC_ASSERT(1 == xNumberEmptyRegions);
+  }
+
+  // at most __XMALLOC_MAX_EMPTY_REGIONS empty regions are kept, the others
+  // are unmapped
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    blocks[i] = xAllocBin(bin);
+  __XMALLOC_ASSERT(NULL != xBaseRegion->prev || NULL != xBaseRegion->next);
+  for (i = NUMBER_BLOCKS - 1; i >= 0; i--)
+    xFreeBin(blocks[i], bin);
+  number  = 0;
+  for (region = xBaseRegion; NULL != region->prev; region = region->prev);
+  for (; NULL != region; region = region->next)
+  {
+    __XMALLOC_ASSERT(0 == region->numberUsedPages);
+    number++;
+  }
+  __XMALLOC_ASSERT(number == xNumberEmptyRegions);
+  __XMALLOC_ASSERT(number <= __XMALLOC_MAX_EMPTY_REGIONS);
+  return 0;
+}
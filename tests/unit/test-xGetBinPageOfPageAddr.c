@@ -11,7 +11,11 @@
 #include "xmalloc-config.h"
 #include "xmalloc.h"
 
+#define NUMBER_STICKY_BINS  64
+
 int main() {
+  xBin sticky[NUMBER_STICKY_BINS];
+  void *addrs[NUMBER_STICKY_BINS];
   int i = 1;
   void *p;
   // allocate memory and check that they lie on the very same xPage
@@ -22,5 +26,20 @@ int main() {
     xFreeBinAddr(addr);
     i++;
   }
+
+  // each of many sticky bins of the same size owns its pages
+  for (i = 0; i < NUMBER_STICKY_BINS; i++)
+  {
+    sticky[i] = xGetStickyBinOfBin(xSmallSize2Bin(40));
+    addrs[i]  = xAllocBin(sticky[i]);
+  }
+  for (i = 0; i < NUMBER_STICKY_BINS; i++)
+  {
+    __XMALLOC_ASSERT(xGetBinOfAddr(addrs[i]) == sticky[i]);
+    __XMALLOC_ASSERT(xGetStickyOfPage((xPage) xGetPageOfAddr(addrs[i])) ==
+                     sticky[i]->sticky);
+    __XMALLOC_ASSERT(40 <= xSizeOfAddr(addrs[i]));
+    xFreeBin(addrs[i], sticky[i]);
+  }
   return 0;
 }
@@ -11,7 +11,16 @@
 #include "xmalloc-config.h"
 #include "xmalloc.h"
 
+#define NUMBER_SIZES  1300
+
+/* 1000 small sizes, then blocks of up to 300 pages */
+#define SIZE(i)       (i < 1000 ? 8 * (i + 1) :                         \
+                        (i - 999) * __XMALLOC_SIZEOF_SYSTEM_PAGE)
+
 int main() {
+  xBin bins[NUMBER_SIZES], bin;
+  void *addr;
+  size_t i;
 
   xBin b      = xGetSpecBin(__XMALLOC_MAX_SMALL_BLOCK_SIZE);
   __XMALLOC_ASSERT(NULL == b->lastPage);
@@ -19,5 +28,58 @@ int main() {
   __XMALLOC_ASSERT(0 == b->sticky);
   xUnGetSpecBin(&b, 0);
 
+  // ungetting bins which are no registered spec bins leaves the spec bins
+  // alone
+  b     = xGetSpecBin(2000);
+  bin   = xGetStickyBinOfBin(b);
+  bins[0] = bin;
+  xUnGetSpecBin(&bins[0], 0);
+  __XMALLOC_ASSERT(NULL == bins[0]);
+  __XMALLOC_ASSERT(1 == ((xSpecBin) b)->ref);
+  bins[0] = xAlignedSize2Bin(500, 64);
+  __XMALLOC_ASSERT(!xIsStaticBin(bins[0]));
+  xUnGetSpecBin(&bins[0], 1);
+  __XMALLOC_ASSERT(1 == xNumberSpecBins);
+  xUnGetStickyBinOfBin(&bin);
+  xUnGetSpecBin(&b, 0);
+  __XMALLOC_ASSERT(0 == xNumberSpecBins);
+
+  // many spec bins of small and multi page blocks, bin and reference
+  // counter of each share a cache line
+  for (i = 0; i < NUMBER_SIZES; i++)
+  {
+    bins[i] = xGetSpecBin(SIZE(i));
+    bin     = xGetSpecBin(SIZE(i));
+    __XMALLOC_ASSERT(bins[i] == bin);
+    xUnGetSpecBin(&bin, 0);
+    if (!xIsStaticBin(bins[i]))
+    {
+      __XMALLOC_ASSERT(0 == ((unsigned long) bins[i] &
+                             (__XMALLOC_CPU_CACHE_LINE - 1)));
+      __XMALLOC_ASSERT((xSpecBin) bins[i] ==
+                       xFindSpecBin(bins[i]->numberBlocks,
+                                    bins[i]->sizeInWords));
+    }
+    addr  = xAllocBin(bins[i]);
+    __XMALLOC_ASSERT(xGetBinOfAddr(addr) == bins[i]);
+    xFreeBin(addr, bins[i]);
+  }
+  __XMALLOC_ASSERT(xNumberSpecBins > 300);
+  __XMALLOC_ASSERT(2 * xNumberSpecBins <= xSpecBinTableSize);
+
+  // the remaining spec bins are found after removing others, spec bins are
+  // shared by sizes of the same number of blocks
+  for (i = 0; i < NUMBER_SIZES; i += 2)
+    xUnGetSpecBin(&bins[i], 0);
+  for (i = 1; i < NUMBER_SIZES; i += 2)
+  {
+    if (!xIsStaticBin(bins[i]))
+      __XMALLOC_ASSERT((xSpecBin) bins[i] ==
+                       xFindSpecBin(bins[i]->numberBlocks,
+                                    bins[i]->sizeInWords));
+    xUnGetSpecBin(&bins[i], 0);
+  }
+  __XMALLOC_ASSERT(0 == xNumberSpecBins);
+
   return 0;
 }
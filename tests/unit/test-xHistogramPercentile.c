@@ -0,0 +1,67 @@
+/**
+ * \file   test-xHistogramPercentile.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the latency histograms of xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+int main() {
+  xHistogramType h;
+  unsigned long long v, p;
+  unsigned int i;
+  void *addr;
+
+  // small values are exact
+  for (v = 0; v < __XMALLOC_HISTOGRAM_SUB_BUCKETS; v++)
+  {
+    __XMALLOC_ASSERT(v == xHistogramBucketOfValue(v));
+    __XMALLOC_ASSERT(v == xHistogramValueOfBucket(v));
+  }
+  // buckets are monotone and contain their lower bound
+  for (i = 1; i < __XMALLOC_HISTOGRAM_BUCKETS; i++)
+  {
+    __XMALLOC_ASSERT(xHistogramValueOfBucket(i) >
+                     xHistogramValueOfBucket(i-1));
+    __XMALLOC_ASSERT(i == xHistogramBucketOfValue(xHistogramValueOfBucket(i)));
+  }
+  __XMALLOC_ASSERT(__XMALLOC_HISTOGRAM_BUCKETS - 1 ==
+                   xHistogramBucketOfValue(~0ULL));
+
+  xHistogramReset(&h);
+  __XMALLOC_ASSERT(0 == xHistogramPercentile(&h, 50.0));
+  for (v = 1; v <= 1000; v++)
+    xHistogramRecord(&h, v);
+  __XMALLOC_ASSERT(1000 == h.count);
+  __XMALLOC_ASSERT(1 == h.min);
+  __XMALLOC_ASSERT(1000 == h.max);
+  __XMALLOC_ASSERT(500500 == h.sum);
+  // the relative error is bounded by the sub-bucket resolution
+  p = xHistogramPercentile(&h, 50.0);
+  __XMALLOC_ASSERT(p >= 500 && p <= 500 + 500 / __XMALLOC_HISTOGRAM_SUB_BUCKETS);
+  p = xHistogramPercentile(&h, 99.0);
+  __XMALLOC_ASSERT(p >= 990 && p <= 1000);
+  __XMALLOC_ASSERT(1000 == xHistogramPercentile(&h, 100.0));
+  __XMALLOC_ASSERT(1 == xHistogramPercentile(&h, 0.0));
+
+  // slow paths are only recorded if configured so
+  addr  = xMalloc(8);
+  xFree(addr);
+  addr  = xMalloc(10 * __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  xFree(addr);
+#ifdef __XMALLOC_HISTOGRAMS
+  __XMALLOC_ASSERT(xLatency[xLatency_NewPageForBin].count >= 1);
+  __XMALLOC_ASSERT(xLatency[xLatency_NewRegion].count >= 1);
+  __XMALLOC_ASSERT(xLatency[xLatency_PageIndexFault].count >= 1);
+  __XMALLOC_ASSERT(1 == xLatency[xLatency_LargeSystem].count);
+#else
+  for (i = 0; i < xLatency_MaxKind; i++)
+    __XMALLOC_ASSERT(0 == xLatency[i].count);
+#endif
+  return 0;
+}
@@ -21,5 +21,14 @@ int main() {
       __XMALLOC_ASSERT(0 == *((char*)(p + j)));
     xFree(p);
   }
+
+#ifndef __XMALLOC_NDEBUG
+  // large chunks are given back as much as they took from the system
+  j = info.currentBytesFromMalloc;
+  void *p  = xMalloc0(6000);
+  __XMALLOC_ASSERT(info.currentBytesFromMalloc > j);
+  xFree(p);
+  __XMALLOC_ASSERT(info.currentBytesFromMalloc == j);
+#endif
   return 0;
 }
@@ -0,0 +1,99 @@
+/**
+ * \file   test-xMalloc0Fresh.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for zeroed allocations from pages fresh from the system
+ *         for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_BLOCKS 1000
+
+static int isZero(const char *addr, size_t size)
+{
+  size_t i;
+  for (i = 0; i < size; i++)
+    if (0 != addr[i])
+      return 0;
+  return 1;
+}
+
+int main() {
+  char *p, *q, *blocks[NUMBER_BLOCKS];
+  xBin bin  = xSmallSize2Bin(200);
+  size_t blockSize  = bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+  int i;
+
+  // blocks of fresh pages are zero, the bin knows the next untouched one
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    blocks[i] = xMalloc0(200);
+    __XMALLOC_ASSERT(isZero(blocks[i], blockSize));
+#ifdef __XMALLOC_HAVE_MMAP
+    __XMALLOC_ASSERT(NULL == bin->zero ||
+                     bin->zero == blocks[i] + blockSize);
+#endif
+    memset(blocks[i], 0x5a, blockSize);
+  }
+
+  // a freed block is dirty even if it was the next untouched one before
+  p = xMalloc(200);
+  memset(p, 0x5a, 200);
+  xFreeBinAddr(p);
+  q = xMalloc0(200);
+  __XMALLOC_ASSERT(p == q && isZero(q, blockSize));
+  memset(q, 0x5a, blockSize);
+  xFree(q);
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    xFree(blocks[i]);
+    blocks[i] = xMalloc0(200);
+    __XMALLOC_ASSERT(isZero(blocks[i], blockSize));
+  }
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    xFree(blocks[i]);
+
+  // the same for typed and constant size allocations
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    blocks[i] = xMalloc0Const(24);
+    __XMALLOC_ASSERT(isZero(blocks[i], 24));
+    memset(blocks[i], 0x5a, 24);
+    if (0 == i % 3)
+      xFreeSize(blocks[i], 24);
+  }
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    if (0 == i % 3)
+      blocks[i] = xMalloc0Const(24);
+    __XMALLOC_ASSERT(0 != i % 3 || isZero(blocks[i], 24));
+    xFreeSize(blocks[i], 24);
+  }
+
+  // growing into a fresh block of a larger bin keeps the contents
+  p = xMalloc(20);
+  memset(p, 0x5a, 20);
+  q = xRealloc0Size(p, 20, 900);
+  __XMALLOC_ASSERT(0x5a == q[19] && isZero(q + 24, 900 - 24));
+  xFreeSize(q, 900);
+
+  // large zeroed chunks
+  p = xMalloc0(100000);
+  __XMALLOC_ASSERT(!xIsBinAddr(p) && isZero(p, 100000));
+  __XMALLOC_ASSERT(100000 == xSizeOfAddr(p));
+  memset(p, 0x5a, 100000);
+  xFree(p);
+  p = xMalloc0(100000);
+  __XMALLOC_ASSERT(isZero(p, 100000));
+  xFree(p);
+  p = xMalloc0Sized(5000);
+  __XMALLOC_ASSERT(isZero(p, 5000));
+  xFreeSized(p, 5000);
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * \file   test-xMallocAligned.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for aligned allocations for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_BLOCKS 200
+
+static int isAligned(const void *addr, size_t alignment)
+{
+  return 0 == ((unsigned long) addr & (alignment - 1));
+}
+
+int main() {
+  size_t alignments[] = { 8, 16, 32, 64, 128, 2048,
+                          __XMALLOC_SIZEOF_SYSTEM_PAGE };
+  size_t sizes[]      = { 1, 24, 32, 100, 192, 200, 600,
+                          __XMALLOC_MAX_SMALL_BLOCK_SIZE, 5000 };
+  void *addrs[NUMBER_BLOCKS];
+  size_t a, s, i;
+  char *p;
+
+  // bins keep the alignment of their block size on all pages
+  __XMALLOC_ASSERT(64 == xBlockAlignmentOfSize(64));
+  __XMALLOC_ASSERT(32 == xBlockAlignmentOfSize(96));
+  __XMALLOC_ASSERT(8 == xBlockAlignmentOfSize(1000));
+  __XMALLOC_ASSERT(64 == xAlignedPageHeaderSize(96));
+  __XMALLOC_ASSERT(128 == xAlignedPageHeaderSize(128));
+  __XMALLOC_ASSERT(__XMALLOC_SIZEOF_PAGE_HEADER == xAlignedPageHeaderSize(24));
+  __XMALLOC_ASSERT(xIsStaticBin(xAlignedSize2Bin(90, 32)));
+  __XMALLOC_ASSERT(96 == (xAlignedSize2Bin(90, 32)->sizeInWords <<
+                          __XMALLOC_LOG_SIZEOF_ALIGNMENT));
+  __XMALLOC_ASSERT(!xIsStaticBin(xAlignedSize2Bin(500, 64)));
+  __XMALLOC_ASSERT(512 == (xAlignedSize2Bin(500, 64)->sizeInWords <<
+                           __XMALLOC_LOG_SIZEOF_ALIGNMENT));
+  __XMALLOC_ASSERT(xAlignedSize2Bin(500, 64) == xAlignedSize2Bin(449, 64));
+  __XMALLOC_ASSERT(NULL == xAlignedSize2Bin(10, __XMALLOC_SIZEOF_SYSTEM_PAGE));
+
+  for (a = 0; a < sizeof(alignments) / sizeof(size_t); a++)
+  {
+    for (s = 0; s < sizeof(sizes) / sizeof(size_t); s++)
+    {
+      for (i = 0; i < NUMBER_BLOCKS; i++)
+      {
+        addrs[i]  = xMallocAligned(sizes[s], alignments[a]);
+        __XMALLOC_ASSERT(isAligned(addrs[i], alignments[a]));
+        __XMALLOC_ASSERT(xSizeOfAddr(addrs[i]) >= sizes[s]);
+        memset(addrs[i], 0x5a, sizes[s]);
+      }
+      for (i = 0; i < NUMBER_BLOCKS; i++)
+      {
+        if (0 == i % 2 || alignments[a] > __XMALLOC_MAX_BIN_ALIGNMENT)
+          xFree(addrs[i]);
+        else
+          xFreeSize(addrs[i], sizes[s]);
+      }
+    }
+  }
+
+  p = xMalloc0Aligned(1000, 128);
+  __XMALLOC_ASSERT(isAligned(p, 128) && xIsBinAddr(p));
+  for (i = 0; i < 1000; i++)
+    __XMALLOC_ASSERT(0 == p[i]);
+  xFreeSize(p, 1000);
+  p = xMalloc0Aligned(5000, 128);
+  __XMALLOC_ASSERT(isAligned(p, 128) && !xIsBinAddr(p));
+  __XMALLOC_ASSERT(5000 == xSizeOfAddr(p));
+  for (i = 0; i < 5000; i++)
+    __XMALLOC_ASSERT(0 == p[i]);
+  p[0]  = 'x';
+  p[4999]  = 'y';
+  // realloc of an aligned large chunk keeps the contents
+  p = xRealloc(p, 8000);
+  __XMALLOC_ASSERT('x' == p[0] && 'y' == p[4999]);
+  xFree(p);
+  p = xMallocAligned(2000, __XMALLOC_SIZEOF_SYSTEM_PAGE);
+  p[0]  = 'x';
+  p = xRealloc(p, 20);
+  __XMALLOC_ASSERT('x' == p[0]);
+  xFree(p);
+  p = xAllocAligned(24);
+  __XMALLOC_ASSERT(isAligned(p, 2 * __XMALLOC_SIZEOF_ALIGNMENT));
+  xFreeSize(p, 24);
+  p = xAlloc0Aligned(40);
+  __XMALLOC_ASSERT(isAligned(p, 2 * __XMALLOC_SIZEOF_ALIGNMENT));
+  for (i = 0; i < 40; i++)
+    __XMALLOC_ASSERT(0 == p[i]);
+  xFreeSize(p, 40);
+
+#ifndef __XMALLOC_NDEBUG
+  // aligned large chunks are accounted for when allocated and when freed
+  i = info.currentBytesFromMalloc;
+  p = xMallocAligned(5000, 2048);
+  __XMALLOC_ASSERT(info.currentBytesFromMalloc >= i + 5000);
+  xFree(p);
+  __XMALLOC_ASSERT(info.currentBytesFromMalloc == i);
+#endif
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * \file   test-xMallocConst.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the allocation with bins resolved at compile time.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+struct point {
+  long  x, y, z;
+};
+
+struct large {
+  char  data[__XMALLOC_MAX_SMALL_BLOCK_SIZE + 1];
+};
+
+int main() {
+  struct point *p;
+  struct large *l;
+  size_t size;
+  char *c;
+  int i;
+
+  // the compile time bins are the ones of xSize2Bin
+  for (size = 1; size <= __XMALLOC_MAX_SMALL_BLOCK_SIZE; size++)
+    __XMALLOC_ASSERT(xConstSize2Bin(size) == xSmallSize2Bin(size));
+  __XMALLOC_ASSERT(xIsSmallConstSize(sizeof(struct point)));
+  __XMALLOC_ASSERT(!xIsSmallConstSize(sizeof(struct large)));
+
+  p = xNew(struct point);
+  __XMALLOC_ASSERT(xIsBinAddr(p));
+  __XMALLOC_ASSERT(xGetBinOfAddr(p) == xConstSize2Bin(sizeof(struct point)));
+  p->x  = p->y  = p->z  = 1;
+  xDelete(p);
+
+  p = xNew0(struct point);
+  __XMALLOC_ASSERT(0 == p->x && 0 == p->y && 0 == p->z);
+  xDelete(p);
+
+  l = xNew0(struct large);
+  __XMALLOC_ASSERT(!xIsBinAddr(l));
+  for (i = 0; i < __XMALLOC_MAX_SMALL_BLOCK_SIZE + 1; i++)
+    __XMALLOC_ASSERT(0 == l->data[i]);
+  xDelete(l);
+
+  // a size unknown at compile time takes the usual way
+  for (size = 1; size <= 2 * __XMALLOC_MAX_SMALL_BLOCK_SIZE; size += 13)
+  {
+    c = xMallocConst(size);
+    c[size-1] = 1;
+    xFreeSize(c, size);
+    c = xMalloc0Const(size);
+    __XMALLOC_ASSERT(0 == c[size-1]);
+    xFreeSize(c, size);
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * \file   test-xMallocNear.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for allocations near other blocks for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_BLOCKS 1000
+
+int main() {
+  void *blocks[NUMBER_BLOCKS], *addr, *hint;
+  xBin bin  = xSmallSize2Bin(64);
+  xPage page;
+  int i, number = 0;
+
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    blocks[i] = xAllocBin(bin);
+  // free every other block of the first page
+  hint  = blocks[0];
+  page  = xGetPageOfBinAddr(hint);
+  for (i = 1; i < NUMBER_BLOCKS; i += 2)
+  {
+    if (xGetPageOfBinAddr(blocks[i]) == page)
+    {
+      xFreeBin(blocks[i], bin);
+      blocks[i] = NULL;
+      number++;
+    }
+  }
+  __XMALLOC_ASSERT(number > 0);
+  __XMALLOC_ASSERT(page != bin->currentPage);
+
+  // the free blocks of the page of the hint are used up first, although it
+  // is not the current page
+  for (i = 1; i < NUMBER_BLOCKS; i += 2)
+  {
+    if (NULL == blocks[i])
+    {
+      blocks[i] = xAllocBinNear(bin, hint);
+      __XMALLOC_ASSERT(xGetPageOfBinAddr(blocks[i]) == page);
+    }
+  }
+  // the page is full now, it is not picked up as current page
+  __XMALLOC_ASSERT(NULL == page->current);
+  addr  = xAllocBinNear(bin, hint);
+  __XMALLOC_ASSERT(xGetPageOfBinAddr(addr) != page);
+  for (i = 0; i < 2 * NUMBER_BLOCKS; i++)
+    xFreeBin(xAllocBin(bin), bin);
+  xFreeBin(addr, bin);
+
+  // the size class decides, blocks of other bins are no hint
+  addr  = xMallocNear(blocks[10], 60);
+  __XMALLOC_ASSERT(xGetBinOfAddr(addr) == bin);
+  xFree(addr);
+  addr  = xMallocNear(blocks[10], 200);
+  __XMALLOC_ASSERT(xGetBinOfAddr(addr) == xSmallSize2Bin(200));
+  hint  = addr;
+  addr  = xMallocNear(hint, 200);
+  __XMALLOC_ASSERT(xGetPageOfBinAddr(addr) == xGetPageOfBinAddr(hint));
+  xFree(addr);
+  xFree(hint);
+  addr  = xMallocNear(NULL, 40);
+  __XMALLOC_ASSERT(xIsBinAddr(addr));
+  xFree(addr);
+  addr  = xMallocNear(blocks[10], 5000);
+  __XMALLOC_ASSERT(!xIsBinAddr(addr));
+  xFree(addr);
+  hint  = xMalloc(5000);
+  addr  = xMallocNear(hint, 64);
+  __XMALLOC_ASSERT(xGetBinOfAddr(addr) == bin);
+  xFree(addr);
+  xFree(hint);
+
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    xFreeBin(blocks[i], bin);
+  __XMALLOC_ASSERT(NULL == bin->lastPage);
+  return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * \file   test-xMallocSized.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the sized allocation without headers for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <malloc.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+int main() {
+  size_t sizes[] = { 1, 8, 100, __XMALLOC_MAX_SMALL_BLOCK_SIZE,
+                     __XMALLOC_MAX_SMALL_BLOCK_SIZE + 1, 4096, 100000 };
+  size_t s, i;
+  char *p, *q;
+
+  for (s = 0; s < sizeof(sizes) / sizeof(size_t); s++)
+  {
+    p = xMallocSized(sizes[s]);
+    __XMALLOC_ASSERT(NULL != p);
+    __XMALLOC_ASSERT((sizes[s] <= __XMALLOC_MAX_SMALL_BLOCK_SIZE) ==
+                     (0 != xIsBinAddr(p)));
+    memset(p, 0x5a, sizes[s]);
+    xFreeSized(p, sizes[s]);
+    p = xMalloc0Sized(sizes[s]);
+    for (i = 0; i < sizes[s]; i++)
+      __XMALLOC_ASSERT(0 == p[i]);
+    xFreeSized(p, sizes[s]);
+  }
+
+  // large chunks are the blocks of the system malloc without a header
+  p = xMallocSized(5000);
+  __XMALLOC_ASSERT(malloc_usable_size(p) >= 5000);
+  xFreeSized(p, 5000);
+
+  // reallocation between small and large sizes keeps the contents
+  p = xMallocSized(10);
+  strcpy(p, "xmalloc");
+  q = xReallocSized(p, 10, 12);
+  __XMALLOC_ASSERT(p == q);
+  p = xReallocSized(q, 12, 500);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc"));
+  p = xReallocSized(p, 500, 20000);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc") && !xIsBinAddr(p));
+  p = xReallocSized(p, 20000, 200000);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc"));
+  p = xReallocSized(p, 200000, 30);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc") && xIsBinAddr(p));
+  xFreeSized(p, 30);
+
+#ifndef __XMALLOC_NDEBUG
+  // large chunks are accounted for when allocated and when freed
+  i = info.currentBytesFromMalloc;
+  p = xMallocSized(5000);
+  q = xMalloc0Sized(6000);
+  __XMALLOC_ASSERT(info.currentBytesFromMalloc == i + 11000);
+  xFreeSized(p, 5000);
+  xFreeSized(q, 6000);
+  __XMALLOC_ASSERT(info.currentBytesFromMalloc == i);
+#endif
+
+  return 0;
+}
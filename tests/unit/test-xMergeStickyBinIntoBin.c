@@ -0,0 +1,110 @@
+/**
+ * \file   test-xMergeStickyBinIntoBin.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for merging sticky bins into their bins and ungetting
+ *         them for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_BLOCKS 2000
+
+/* the pages of bin form a consistent list owned by bin, returns their
+ * number */
+static long checkPages(xBin bin)
+{
+  xPage page;
+  long number = 0;
+  int current = 0;
+  for (page = bin->lastPage; NULL != page; page = page->prev)
+  {
+    __XMALLOC_ASSERT(xGetBinOfPage(page) == bin);
+    __XMALLOC_ASSERT(NULL == page->next || page->next->prev == page);
+    if (page == bin->currentPage)
+      current = 1;
+    number++;
+  }
+  __XMALLOC_ASSERT(current || __XMALLOC_ZERO_PAGE == bin->currentPage);
+  return number;
+}
+
+int main() {
+  long *blocks[NUMBER_BLOCKS], *addr;
+  xBin bin  = xSmallSize2Bin(48);
+  xBin specBin, sBin;
+  long pages, reused;
+  int i, j;
+
+  // blocks of the sticky bin stay valid and belong to bin
+  for (i = 0; i < NUMBER_BLOCKS / 2; i++)
+    blocks[i] = xAllocBin(bin);
+  sBin  = xGetStickyBinOfBin(bin);
+  for (i = NUMBER_BLOCKS / 2; i < NUMBER_BLOCKS; i++)
+  {
+    blocks[i]     = xAllocBin(sBin);
+    *blocks[i]    = i;
+    __XMALLOC_ASSERT(xGetBinOfAddr(blocks[i]) == sBin);
+  }
+  for (i = NUMBER_BLOCKS / 2; i < NUMBER_BLOCKS; i += 2)
+    xFreeBin(blocks[i], sBin);
+  pages = checkPages(bin);
+  xMergeStickyBinIntoBin(sBin, bin);
+  __XMALLOC_ASSERT(NULL == xStickyBins);
+  __XMALLOC_ASSERT(checkPages(bin) > pages);
+  for (i = NUMBER_BLOCKS / 2 + 1; i < NUMBER_BLOCKS; i += 2)
+  {
+    __XMALLOC_ASSERT(xGetBinOfAddr(blocks[i]) == bin);
+    __XMALLOC_ASSERT(i == *blocks[i]);
+  }
+
+  // the free blocks of the merged pages are handed out by bin
+  reused  = 0;
+  for (i = NUMBER_BLOCKS / 2; i < NUMBER_BLOCKS; i += 2)
+  {
+    addr  = xAllocBin(bin);
+    for (j = NUMBER_BLOCKS / 2 + 1; j < NUMBER_BLOCKS; j += 2)
+    {
+      if (xGetPageOfAddr(addr) == xGetPageOfAddr(blocks[j]))
+      {
+        reused++;
+        break;
+      }
+    }
+    blocks[i] = addr;
+  }
+  __XMALLOC_ASSERT(reused > 0);
+  checkPages(bin);
+  // pages are released as soon as their last block is freed
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    xFreeBin(blocks[i], bin);
+  __XMALLOC_ASSERT(0 == checkPages(bin));
+
+  // merging into an empty bin
+  specBin = xGetSpecBin(3000);
+  __XMALLOC_ASSERT(__XMALLOC_ZERO_PAGE == specBin->currentPage);
+  sBin    = xGetStickyBinOfBin(specBin);
+  for (i = 0; i < 40; i++)
+    blocks[i] = xAllocBin(sBin);
+  xMergeStickyBinIntoBin(sBin, specBin);
+  __XMALLOC_ASSERT((40 + specBin->numberBlocks - 1) / specBin->numberBlocks ==
+                   checkPages(specBin));
+  addr  = xAllocBin(specBin);
+  checkPages(specBin);
+  xFreeBin(addr, specBin);
+  for (i = 0; i < 40; i++)
+    xFreeBin(blocks[i], specBin);
+
+  // ungetting a sticky bin releases its pages at once
+  sBin  = xGetStickyBinOfBin(bin);
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    blocks[i] = xAllocBin(sBin);
+  xUnGetStickyBinOfBin(&sBin);
+  __XMALLOC_ASSERT(NULL == sBin);
+  __XMALLOC_ASSERT(NULL == xStickyBins);
+  return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * \file   test-xPreload.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the drop-in replacement of the malloc family.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xmalloc-config.h"
+#include "xassert.h"
+
+#define NUMBER_THREADS  4
+#define NUMBER_LOOPS    20000
+
+static int isAligned(const void *addr, size_t alignment)
+{
+  return 0 == ((uintptr_t) addr & (alignment - 1));
+}
+
+static void *churn(void *arg)
+{
+  void *addrs[64];
+  unsigned int seed = (unsigned int) (uintptr_t) arg;
+  int i, j;
+  for (i = 0; i < NUMBER_LOOPS; i++)
+  {
+    for (j = 0; j < 64; j++)
+    {
+      seed      = seed * 1103515245 + 12345;
+      addrs[j]  = malloc(1 + (seed >> 8) % 2048);
+      *(char *) addrs[j]  = (char) j;
+    }
+    for (j = 0; j < 64; j++)
+    {
+      __XMALLOC_ASSERT((char) j == *(char *) addrs[j]);
+      free(addrs[j]);
+    }
+  }
+  return NULL;
+}
+
+int main() {
+  pthread_t threads[NUMBER_THREADS];
+  char *p, *q, *s;
+  void *a;
+  size_t i;
+  // hides the overflowing count of calloc() from the compiler
+  volatile size_t hugeCount = SIZE_MAX / 2;
+  int status;
+
+  // small blocks come from the bins of xmalloc: the usable size is the one
+  // of a bin whose blocks keep the alignment of the C library
+  p = malloc(20);
+  __XMALLOC_ASSERT(NULL != p);
+  __XMALLOC_ASSERT(isAligned(p, 2 * sizeof(void*)));
+  __XMALLOC_ASSERT(32 == malloc_usable_size(p));
+  for (i = 1; i <= __XMALLOC_MAX_SMALL_BLOCK_SIZE; i++)
+  {
+    q = malloc(i);
+    __XMALLOC_ASSERT(isAligned(q, 2 * sizeof(void*)));
+    __XMALLOC_ASSERT(malloc_usable_size(q) >= i);
+    memset(q, 0xff, i);
+    free(q);
+  }
+  free(p);
+
+  q = malloc(4 * __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  __XMALLOC_ASSERT(malloc_usable_size(q) >= 4 * __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  free(q);
+  free(NULL);
+
+  p = calloc(10, 10);
+  for (i = 0; i < 100; i++)
+    __XMALLOC_ASSERT(0 == p[i]);
+  free(p);
+  p = calloc(1000, 10);
+  for (i = 0; i < 10000; i++)
+    __XMALLOC_ASSERT(0 == p[i]);
+  free(p);
+  __XMALLOC_ASSERT(NULL == calloc(hugeCount, 4));
+
+  // realloc keeps the contents from small to large blocks and back
+  p = malloc(10);
+  strcpy(p, "xmalloc");
+  p = realloc(p, 100);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc"));
+  p = realloc(p, 100000);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc"));
+  p = realloc(p, 200000);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc"));
+  p = realloc(p, 16);
+  __XMALLOC_ASSERT(0 == strcmp(p, "xmalloc"));
+  q = realloc(p, 12);
+  __XMALLOC_ASSERT(p == q);
+  __XMALLOC_ASSERT(NULL == realloc(q, 0));
+  p = realloc(NULL, 50);
+  __XMALLOC_ASSERT(NULL != p);
+  free(p);
+
+  // aligned allocations
+  __XMALLOC_ASSERT(0 == posix_memalign(&a, 64, 100));
+  __XMALLOC_ASSERT(isAligned(a, 64));
+  free(a);
+  __XMALLOC_ASSERT(0 == posix_memalign(&a, 16, 100));
+  __XMALLOC_ASSERT(isAligned(a, 16));
+  free(a);
+  __XMALLOC_ASSERT(0 != posix_memalign(&a, 24, 100));
+  a = aligned_alloc(4096, 4096);
+  __XMALLOC_ASSERT(isAligned(a, 4096));
+  free(a);
+  a = memalign(256, 10);
+  __XMALLOC_ASSERT(isAligned(a, 256));
+  __XMALLOC_ASSERT(malloc_usable_size(a) >= 10);
+  a = realloc(a, 5000);
+  free(a);
+  a = valloc(10);
+  __XMALLOC_ASSERT(isAligned(a, sysconf(_SC_PAGESIZE)));
+  free(a);
+
+  // blocks allocated inside of the C library
+  s = strdup("xmalloc");
+  __XMALLOC_ASSERT(0 == strcmp(s, "xmalloc"));
+  free(s);
+
+  // concurrent callers are serialized
+  for (i = 0; i < NUMBER_THREADS; i++)
+    pthread_create(&threads[i], NULL, churn, (void *) (i + 1));
+  for (i = 0; i < NUMBER_THREADS; i++)
+    pthread_join(threads[i], NULL);
+
+  // the allocator is usable in a forked child
+  p = malloc(100);
+  if (0 == fork())
+  {
+    q = malloc(100);
+    free(p);
+    free(q);
+    _exit(0);
+  }
+  wait(&status);
+  __XMALLOC_ASSERT(WIFEXITED(status) && 0 == WEXITSTATUS(status));
+  free(p);
+  return 0;
+}
@@ -17,13 +17,13 @@ int main() {
   void *p = xMalloc0(2 * __XMALLOC_SIZEOF_PAGE);
   
   // realloc large
-  p = xRealloc0Large(p, __XMALLOC_SIZEOF_PAGE);
+  p = xRealloc0Large(p, 2 * __XMALLOC_SIZEOF_PAGE, __XMALLOC_SIZEOF_PAGE);
   __XMALLOC_ASSERT(NULL != p);
   __XMALLOC_ASSERT(0 == *(char *)p);
   __XMALLOC_ASSERT(0 == *((char *)p + __XMALLOC_SIZEOF_PAGE -1));
 
   // realloc large again
-  p = xRealloc0Large(p, 10 * __XMALLOC_SIZEOF_PAGE);
+  p = xRealloc0Large(p, __XMALLOC_SIZEOF_PAGE, 10 * __XMALLOC_SIZEOF_PAGE);
   __XMALLOC_ASSERT(NULL != p);
   __XMALLOC_ASSERT(0 == *(char *)p);
   __XMALLOC_ASSERT(0 == *((char *)p + __XMALLOC_SIZEOF_PAGE -1));
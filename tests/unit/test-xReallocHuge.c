@@ -0,0 +1,59 @@
+/**
+ * \file   test-xReallocHuge.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for the reallocation of huge memory chunks for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define MB (1024 * 1024)
+
+int main() {
+  size_t i;
+  char *p;
+
+  p = xMalloc(__XMALLOC_HUGE_BLOCK_SIZE);
+  __XMALLOC_ASSERT(!xIsBinAddr(p));
+  __XMALLOC_ASSERT(__XMALLOC_HUGE_BLOCK_SIZE == xSizeOfAddr(p));
+  __XMALLOC_ASSERT(0 == ((unsigned long) p & __XMALLOC_SIZEOF_ALIGNMENT_MINUS_ONE));
+  for (i = 0; i < __XMALLOC_HUGE_BLOCK_SIZE; i += 4096)
+    p[i]  = (char) (i >> 12);
+  xFree(p);
+
+  // growing by doubling keeps the contents
+  p = xMalloc(100000);
+  memset(p, 0x5a, 100000);
+  p = xRealloc(p, 2 * MB);
+  __XMALLOC_ASSERT(0x5a == p[0] && 0x5a == p[99999]);
+  for (i = 100000; i < 2 * MB; i += 4096)
+    p[i]  = 0x5b;
+  p = xRealloc(p, 200 * MB);
+  __XMALLOC_ASSERT(200 * MB == xSizeOfAddr(p));
+  __XMALLOC_ASSERT(0x5a == p[99999] && 0x5b == p[100000]);
+  p[200 * MB - 1] = 1;
+  p = xReallocSize(p, 200 * MB, 3 * MB);
+  __XMALLOC_ASSERT(0x5a == p[0] && 0x5b == p[100000 + 400 * 4096]);
+  xFreeSize(p, 3 * MB);
+
+  // zeroing reallocations of huge chunks
+  p = xMalloc0(2 * MB);
+  for (i = 0; i < 2 * MB; i += 512)
+    __XMALLOC_ASSERT(0 == p[i]);
+  memset(p, 0x5a, 2 * MB);
+  p = xReallocSize(p, 2 * MB, 2 * MB - 1000);
+  p = xRealloc0Size(p, 2 * MB - 1000, 8 * MB);
+  __XMALLOC_ASSERT(0x5a == p[2 * MB - 1001]);
+  for (i = 2 * MB - 1000; i < 8 * MB; i += 100)
+    __XMALLOC_ASSERT(0 == p[i]);
+
+  // back to small blocks
+  p = xRealloc(p, 100);
+  __XMALLOC_ASSERT(xIsBinAddr(p) && 0x5a == p[99]);
+  xFree(p);
+  return 0;
+}
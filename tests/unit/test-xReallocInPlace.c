@@ -0,0 +1,90 @@
+/**
+ * \file   test-xReallocInPlace.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for reallocations keeping their block for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+int main() {
+  char *p, *q;
+  size_t i;
+
+  // shrinking to the next smaller size class keeps the block
+  p = xMalloc(1000);
+  memset(p, 0x5a, 1000);
+  q = xReallocSize(p, 1000, 800);
+  __XMALLOC_ASSERT(p == q);
+  // growing within the kept block, too
+  q = xReallocSize(q, 800, 1000);
+  __XMALLOC_ASSERT(p == q);
+  // shrinking a lot moves the block
+  q = xReallocSize(q, 1000, 100);
+  __XMALLOC_ASSERT(p != q && 0x5a == q[99]);
+  xFreeSize(q, 100);
+
+  // zeroing reallocations clear the grown part of a kept block
+  p = xMalloc0(120);
+  memset(p, 0x5a, 120);
+  q = xRealloc0Size(p, 120, 110);
+  __XMALLOC_ASSERT(p == q);
+  q = xRealloc0Size(q, 100, 128);
+  __XMALLOC_ASSERT(p == q && 0x5a == q[99]);
+  for (i = 100; i < 128; i++)
+    __XMALLOC_ASSERT(0 == q[i]);
+  xFreeSize(q, 128);
+
+  // moderately shrinking large blocks does not call the system, the block
+  // has its new usable size
+  p = xMalloc(10000);
+  memset(p, 0x5a, 10000);
+  q = xReallocSize(p, 10000, 8000);
+  __XMALLOC_ASSERT(p == q && 8000 == xSizeOfAddr(q));
+  q = xReallocSize(q, 8000, 2000);
+  __XMALLOC_ASSERT(0x5a == q[1999]);
+  // large to small always moves
+  q = xReallocSize(q, 2000, 1000);
+  __XMALLOC_ASSERT(xIsBinAddr(q) && 0x5a == q[999]);
+  xFreeSize(q, 1000);
+
+  // growing a shrunk large block with zeroing clears everything behind the
+  // shrunk size, with and without the old size given
+  p = xMalloc(2000);
+  memset(p, 0xab, 2000);
+  q = xReallocSize(p, 2000, 1600);
+  __XMALLOC_ASSERT(p == q);
+  q = xRealloc0Size(q, 1600, 1900);
+  __XMALLOC_ASSERT(p == q && 0xab == (unsigned char) q[1599]);
+  for (i = 1600; i < 1900; i++)
+    __XMALLOC_ASSERT(0 == q[i]);
+  memset(q, 0xab, 1900);
+  q = xRealloc(q, 1704);
+  q = xRealloc0(q, 2000);
+  __XMALLOC_ASSERT(p == q);
+  for (i = 1704; i < 2000; i++)
+    __XMALLOC_ASSERT(0 == q[i]);
+  xFree(q);
+  // shrinking by less than a word keeps the allocated size
+  p = xMalloc(2001);
+  memset(p, 0xab, 2001);
+  q = xReallocSize(p, 2001, 2000);
+  __XMALLOC_ASSERT(p == q && 2001 == xSizeOfAddr(q));
+  q = xRealloc0Size(q, 2000, 2001);
+  __XMALLOC_ASSERT(p == q && 0 == q[2000]);
+  xFree(q);
+
+  // sized chunks without header
+  p = xMallocSized(700);
+  q = xReallocSized(p, 700, 600);
+  __XMALLOC_ASSERT(p == q);
+  q = xReallocSized(q, 600, 200);
+  __XMALLOC_ASSERT(p != q);
+  xFreeSized(q, 200);
+
+  return 0;
+}
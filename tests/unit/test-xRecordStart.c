@@ -0,0 +1,95 @@
+/**
+ * \file   test-xRecordStart.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for recording and reading back allocation streams,
+ *         built only with --enable-record.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_LOOPS 20000
+
+int main() {
+  char fileName[]  = "/tmp/test-xRecordStart.XXXXXX";
+  int fd  = mkstemp(fileName);
+  xRecordReader reader;
+  xRecordEntry entry;
+  void *p, *q, *r;
+  xBin b;
+  long i;
+
+  __XMALLOC_ASSERT(-1 != fd);
+  close(fd);
+
+  p = xMalloc(8);
+  __XMALLOC_ASSERT(0 == xRecordStart(fileName));
+  __XMALLOC_ASSERT(-1 == xRecordStart(fileName));
+  q = xMalloc(24);                          // id 1
+  r = xMalloc(2 * __XMALLOC_MAX_SMALL_BLOCK_SIZE);  // id 2
+  q = xReallocSize(q, 24, 100);             // id 1 -> id 3
+  b = xGetSpecBin(64);                      // static bin, id 0
+  xFree(xAllocBin(b));                      // id 4
+  b = xGetSpecBin(360);                     // id 5
+  xFreeBin(xAllocBin(b), b);                // id 6
+  xUnGetSpecBin(&b, 1);
+  xFree(q);
+  xFree(r);
+  xFree(p);                                 // not recorded before
+  // fill several chunks
+  for (i = 0; i < NUMBER_LOOPS; i++)
+    xFree(xMalloc(i % 2000 + 1));
+  __XMALLOC_ASSERT(0 < xRecordStop());
+  __XMALLOC_ASSERT(-1 == xRecordStop());
+
+  __XMALLOC_ASSERT(0 == xRecordOpen(&reader, fileName));
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Malloc == entry.op && 1 == entry.id &&
+      24 == entry.size);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Malloc == entry.op && 2 == entry.id &&
+      2 * __XMALLOC_MAX_SMALL_BLOCK_SIZE == entry.size);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Realloc == entry.op && 1 == entry.oldId &&
+      3 == entry.id && 24 == entry.oldSize && 100 == entry.size);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_GetSpecBin == entry.op && 0 == entry.id &&
+      64 == entry.size);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_AllocBin == entry.op && 4 == entry.id &&
+      0 == entry.oldId && 64 == entry.size);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Free == entry.op && 4 == entry.id);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_GetSpecBin == entry.op && 5 == entry.id &&
+      360 == entry.size);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_AllocBin == entry.op && 6 == entry.id &&
+      5 == entry.oldId && entry.size >= 360);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Free == entry.op && 6 == entry.id);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Free == entry.op && 3 == entry.id);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Free == entry.op && 2 == entry.id);
+  __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+  __XMALLOC_ASSERT(xRecord_Free == entry.op && 0 == entry.id);
+  for (i = 0; i < NUMBER_LOOPS; i++)
+  {
+    __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+    __XMALLOC_ASSERT(xRecord_Malloc == entry.op && 7 + i == entry.id &&
+        i % 2000 + 1 == entry.size);
+    __XMALLOC_ASSERT(1 == xRecordRead(&reader, &entry));
+    __XMALLOC_ASSERT(xRecord_Free == entry.op && 7 + i == entry.id);
+  }
+  __XMALLOC_ASSERT(0 == xRecordRead(&reader, &entry));
+  xRecordClose(&reader);
+  unlink(fileName);
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * \file   test-xSpecBinSpan.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for pages of spec bins spanning several system pages
+ *         for xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+#define NUMBER_BLOCKS 200
+#define SIZE          1500
+
+int main() {
+  void *blocks[NUMBER_BLOCKS], *addr, *tail = NULL;
+  xBin bin, sBin;
+  size_t size, blockSize, numberPages;
+  int i, j, tailIndex = 0, number = 0;
+
+  // all sizes between the static bins and large blocks: the page header and
+  // the tail of a span waste at most 2% of it
+  for (size = __XMALLOC_MAX_SMALL_BLOCK_SIZE + __XMALLOC_SIZEOF_ALIGNMENT;
+       size <= __XMALLOC_SIZEOF_PAGE; size += __XMALLOC_SIZEOF_ALIGNMENT)
+  {
+    bin         = xGetSpecBin(size);
+    blockSize   = bin->sizeInWords << __XMALLOC_LOG_SIZEOF_ALIGNMENT;
+    numberPages = (size_t) xPagesOfBin(bin);
+    __XMALLOC_ASSERT(blockSize >= size);
+    __XMALLOC_ASSERT(numberPages <= __XMALLOC_MAX_SPAN_PAGES);
+    __XMALLOC_ASSERT((size_t) bin->numberBlocks * blockSize +
+                     __XMALLOC_SIZEOF_PAGE_HEADER <=
+                     numberPages * __XMALLOC_SIZEOF_SYSTEM_PAGE);
+    if (numberPages < __XMALLOC_MAX_SPAN_PAGES)
+      __XMALLOC_ASSERT((numberPages * __XMALLOC_SIZEOF_SYSTEM_PAGE -
+                        (size_t) bin->numberBlocks * size) *
+                       __XMALLOC_SPAN_WASTE_DIVISOR <=
+                       numberPages * __XMALLOC_SIZEOF_SYSTEM_PAGE);
+    xUnGetSpecBin(&bin, 0);
+  }
+  __XMALLOC_ASSERT(0 == xNumberSpecBins);
+
+  // 2 blocks per system page, but 19 per span of 7 pages
+  bin = xGetSpecBin(SIZE);
+  __XMALLOC_ASSERT(bin->numberBlocks > 2 * xPagesOfBin(bin));
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    blocks[i] = xAllocBin(bin);
+    memset(blocks[i], i, SIZE);
+  }
+  // blocks behind the first page of their span are found by their size and
+  // their bin
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    for (j = 0; j < SIZE; j++)
+      __XMALLOC_ASSERT((unsigned char) i == ((unsigned char *) blocks[i])[j]);
+    __XMALLOC_ASSERT(xSizeOfAddr(blocks[i]) >= SIZE);
+    if (xIsSpanAddr(blocks[i]))
+    {
+      __XMALLOC_ASSERT(!xIsBinAddr(blocks[i]));
+      __XMALLOC_ASSERT(xGetBinOfPage(xGetPageOfSpanAddr(blocks[i])) == bin);
+      tail      = blocks[i];
+      tailIndex = i;
+      number++;
+    }
+    else
+    {
+      __XMALLOC_ASSERT(xGetBinOfAddr(blocks[i]) == bin);
+    }
+  }
+  __XMALLOC_ASSERT(number > NUMBER_BLOCKS / 2);
+
+  // blocks of spans are freed by all functions
+  addr  = xRealloc(tail, 3000);
+  for (j = 0; j < SIZE; j++)
+    __XMALLOC_ASSERT((unsigned char) tailIndex == ((unsigned char *) addr)[j]);
+  blocks[tailIndex] = addr;
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+  {
+    if (blocks[i] == addr)
+      xFree(blocks[i]);
+    else if (0 == i % 3)
+      xFreeBin(blocks[i], bin);
+    else if (1 == i % 3)
+      xFree(blocks[i]);
+    else
+      xFreeSize(blocks[i], SIZE);
+  }
+  // the spans are given back, their pages are no span pages anymore
+  __XMALLOC_ASSERT(NULL == bin->lastPage);
+  __XMALLOC_ASSERT(!xIsSpanAddr(tail));
+
+  // spans of sticky bins are given back when ungetting them
+  sBin  = xGetStickyBinOfBin(bin);
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    blocks[i] = xAllocBin(sBin);
+  xUnGetStickyBinOfBin(&sBin);
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    __XMALLOC_ASSERT(!xIsSpanAddr(blocks[i]));
+  xUnGetSpecBin(&bin, 0);
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * \file   test-xTraceFlush.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Unit test for flushing the slow-path event trace of xmalloc.
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "xmalloc-config.h"
+#include "xmalloc.h"
+
+// enough blocks of the largest small size to fill more regions than are kept
+// mapped when empty
+#define NUMBER_BLOCKS ((__XMALLOC_MAX_EMPTY_REGIONS + 2) * \
+                        __XMALLOC_MIN_NUMBER_PAGES_PER_REGION * \
+                        (__XMALLOC_SIZEOF_SYSTEM_PAGE / \
+                         __XMALLOC_MAX_SMALL_BLOCK_SIZE))
+
+static void *blocks[NUMBER_BLOCKS];
+
+static void *traceThread(void *arg) {
+  xFree(xMalloc(10 * __XMALLOC_MAX_SMALL_BLOCK_SIZE));
+  return arg;
+}
+
+int main() {
+  char fileName[]  = "/tmp/test-xTraceFlush.XXXXXX";
+  int fd  = mkstemp(fileName);
+  xTraceHeader header;
+  xTraceEventType event;
+  FILE *file;
+  long i, numberEvents;
+  long counts[xTrace_MaxKind] = { 0 };
+  unsigned long long lastTsc  = 0;
+  void *p, *large;
+  xBin b;
+  pthread_t thread;
+  int rc;
+
+  __XMALLOC_ASSERT(-1 != fd);
+  close(fd);
+
+  // region map, page index fault, page refill and page release
+  p = xMalloc(8);
+  xFree(p);
+  // region unmap once more than __XMALLOC_MAX_EMPTY_REGIONS regions are empty
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    blocks[i] = xMalloc(__XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  for (i = 0; i < NUMBER_BLOCKS; i++)
+    xFree(blocks[i]);
+  // large malloc
+  large = xMalloc(10 * __XMALLOC_MAX_SMALL_BLOCK_SIZE);
+  xFree(large);
+  // spec bin creation
+  b = xGetSpecBin(2 * __XMALLOC_SIZEOF_SYSTEM_PAGE);
+  xUnGetSpecBin(&b, 1);
+  // the second thread takes over the buffer of the first one
+  // the calls are not made inside __XMALLOC_ASSERT(), which may be empty
+  for (i = 0; i < 2; i++)
+  {
+    rc  = pthread_create(&thread, NULL, traceThread, NULL);
+    __XMALLOC_ASSERT(0 == rc);
+    rc  = pthread_join(thread, NULL);
+    __XMALLOC_ASSERT(0 == rc);
+  }
+
+#ifdef __XMALLOC_TRACE
+  numberEvents  = xTraceFlush(fileName);
+  __XMALLOC_ASSERT(5 <= numberEvents);
+  file  = fopen(fileName, "rb");
+  __XMALLOC_ASSERT(NULL != file);
+  __XMALLOC_ASSERT(1 == fread(&header, sizeof(header), 1, file));
+  __XMALLOC_ASSERT(0 == memcmp(header.magic, __XMALLOC_TRACE_MAGIC, 8));
+  __XMALLOC_ASSERT(sizeof(xTraceEventType) == header.eventSize);
+  __XMALLOC_ASSERT(3 == header.numberThreads);
+  __XMALLOC_ASSERT(numberEvents == header.numberEvents);
+  for (i = 0; i < numberEvents; i++) {
+    __XMALLOC_ASSERT(1 == fread(&event, sizeof(event), 1, file));
+    __XMALLOC_ASSERT(event.kind < xTrace_MaxKind);
+    __XMALLOC_ASSERT(lastTsc <= event.tsc);
+    lastTsc = event.tsc;
+    counts[event.kind]++;
+    // large mallocs record the address handed out
+    if (xTrace_LargeMalloc == event.kind && 0 == event.thread)
+      __XMALLOC_ASSERT((unsigned long long) (unsigned long) large ==
+                       event.arg0);
+  }
+  fclose(file);
+  __XMALLOC_ASSERT(1 <= counts[xTrace_RegionMap]);
+  __XMALLOC_ASSERT(1 <= counts[xTrace_RegionUnmap]);
+  __XMALLOC_ASSERT(1 <= counts[xTrace_PageIndexFault]);
+  __XMALLOC_ASSERT(1 <= counts[xTrace_PageRefill]);
+  __XMALLOC_ASSERT(1 <= counts[xTrace_PageRelease]);
+  __XMALLOC_ASSERT(3 == counts[xTrace_LargeMalloc]);
+  __XMALLOC_ASSERT(1 == counts[xTrace_SpecBinCreate]);
+#else
+  (void) header;
+  (void) event;
+  (void) file;
+  (void) i;
+  (void) numberEvents;
+  (void) counts;
+  (void) lastTsc;
+  (void) large;
+  __XMALLOC_ASSERT(-1 == xTraceFlush(fileName));
+#endif
+  unlink(fileName);
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * \file   xtrace2json.c
+ * \author Christian Eder ( ederc@mathematik.uni-kl.de )
+ * \date   October 2012
+ * \brief  Converts a trace file written by xTraceFlush() to the Chrome trace
+ *         event JSON format, which can be loaded in chrome://tracing or
+ *         Perfetto for timeline analysis.
+ *         Usage: xtrace2json <trace file> [<json file>]
+ *         This file is part of XMALLOC, licensed under the GNU General
+ *         Public License version 3. See COPYING for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xmalloc-config.h"
+#include "trace.h"
+
+static const char *xTraceKindName[xTrace_MaxKind] = {
+  "page refill",
+  "page release",
+  "region map",
+  "region unmap",
+  "page index fault",
+  "large malloc",
+  "spec bin create"
+};
+
+static const char *xTraceArgName[xTrace_MaxKind][2] = {
+  { "bin",    "page" },
+  { "page",   "pages" },
+  { "addr",   "pages" },
+  { "addr",   "pages" },
+  { "start",  "end" },
+  { "addr",   "size" },
+  { "bin",    "size" }
+};
+
+/* the second argument of a page refill is an address as well */
+#define xTraceArg1IsAddr(kind) (xTrace_PageRefill == (kind))
+
+int main(int argc, char *argv[])
+{
+  xTraceHeader header;
+  xTraceEventType event;
+  unsigned long long i, written = 0, firstTsc = 0;
+  FILE *in, *out = stdout;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <trace file> [<json file>]\n", argv[0]);
+    return 1;
+  }
+  in  = fopen(argv[1], "rb");
+  if (NULL == in)
+  {
+    fprintf(stderr, "cannot open %s\n", argv[1]);
+    return 1;
+  }
+  if (1 != fread(&header, sizeof(header), 1, in) ||
+      0 != memcmp(header.magic, __XMALLOC_TRACE_MAGIC, sizeof(header.magic)) ||
+      sizeof(xTraceEventType) != header.eventSize)
+  {
+    fprintf(stderr, "%s is not an xmalloc trace file\n", argv[1]);
+    fclose(in);
+    return 1;
+  }
+  if (argc > 2)
+  {
+    out = fopen(argv[2], "w");
+    if (NULL == out)
+    {
+      fprintf(stderr, "cannot open %s\n", argv[2]);
+      fclose(in);
+      return 1;
+    }
+  }
+
+  fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  for (i = 0; i < header.numberEvents; i++)
+  {
+    if (1 != fread(&event, sizeof(event), 1, in))
+    {
+      fprintf(stderr, "%s is truncated after %llu events\n", argv[1], i);
+      break;
+    }
+    if (event.kind >= xTrace_MaxKind)
+      continue;
+    if (0 == written)
+      firstTsc  = event.tsc;
+    fprintf(out, (xTraceArg1IsAddr(event.kind) ?
+        "%s{\"name\":\"%s\",\"cat\":\"xmalloc\",\"ph\":\"i\","
+        "\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+        "\"args\":{\"%s\":\"0x%llx\",\"%s\":\"0x%llx\"}}\n" :
+        "%s{\"name\":\"%s\",\"cat\":\"xmalloc\",\"ph\":\"i\","
+        "\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+        "\"args\":{\"%s\":\"0x%llx\",\"%s\":%llu}}\n"),
+        (0 == written ? "" : ","), xTraceKindName[event.kind],
+        (double) (event.tsc - firstTsc) / header.ticksPerNs / 1000.0,
+        event.thread,
+        xTraceArgName[event.kind][0], event.arg0,
+        xTraceArgName[event.kind][1], event.arg1);
+    written++;
+  }
+  fprintf(out, "]}\n");
+
+  fclose(in);
+  if (stdout != out)
+    fclose(out);
+  return 0;
+}